@@ -0,0 +1,99 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// bench times every group from start to finish on the host, for a given cost of a pass 
+// through loop().
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "hal.h"
+#include "Arduino.h"
+#include "group.h"
+#include "movesequence.h"
+
+//
+//   silly_box_bench [loop-us]
+//
+// Each group runs on its own, the way loop() drives it: a pass through group::loop() costs
+// loop-us (100) and when nothing is due the processor sleeps to the next Timer0 overflow 
+// before the earliest deadline.  Prints each group's time in ms and how late (ms) its 
+// primary sequence finished against its schedule, the timing drift accumulated over the 
+// whole group.  Deadlines don't drift, so no group may finish later than the one pass it
+// can take to notice its last deadline.  A group that hasn't finished in maxGroupMs, or
+// finished later than that, is reported and makes the exit status 1.
+//
+
+extern group switchGroupTable[];
+extern const int numSwitchGroups;
+extern group proxGroupTable[];
+extern const int numProxGroups;
+
+static const uint32_t maxGroupMs = 60000;
+
+static long runGroup(group& aGroup, uint32_t loopUs, long& lateMs)
+{
+  randomSeed(1);
+  uint32_t startMs = millis();
+  aGroup.start();
+  while (aGroup.loop() != group::GROUP_COMPLETE)
+  {
+    hal::advance(loopUs);
+    while (static_cast<int32_t> (aGroup.getNextDeadline() - millis()) > 0)
+    {
+      hal::advance(hal::timer0OverflowUs - hal::getMicros() % hal::timer0OverflowUs);
+    }
+    if (millis() - startMs > maxGroupMs) 
+    {
+      aGroup.reset();
+      return -1;
+    }
+  }
+  lateMs = static_cast<int32_t> (millis() - aGroup.getPrimaryDeadline());
+  aGroup.reset();
+  return millis() - startMs;
+}
+
+static bool report(const char* pName, int index, group& aGroup, uint32_t loopUs)
+{
+  long lateMs = 0;
+  long maxLateMs = loopUs/1000;
+  long ms = runGroup(aGroup, loopUs, lateMs);
+  if (ms < 0) 
+  {
+    printf("%s%-2d did not finish\n", pName, index);
+    return false;
+  }
+  printf("%s%-2d %6ld late %ld%s\n", pName, index, ms, lateMs, lateMs > maxLateMs ? "  TOO LATE" : "");
+  return lateMs <= maxLateMs;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t loopUs = (argc > 1) ? atol(argv[1]) : 100;
+  bool ok = true;
+
+  moveSequence::setup();
+  for (int i = 0; i < numSwitchGroups; i++) ok = report("S", i, switchGroupTable[i], loopUs) && ok;
+  for (int i = 0; i < numProxGroups; i++) ok = report("P", i, proxGroupTable[i], loopUs) && ok;
+  return ok ? 0 : 1;
+}
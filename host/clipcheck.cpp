@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// clipcheck plays the voice clips through the sketch's IMA-ADPCM decoder.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "hal.h"
+#include "Arduino.h"
+#include "clips.h"
+
+//
+//   silly_box_clipcheck FILE
+//
+// Plays every clip through toneSynth's sample handler and writes the duty cycle (OCR2B) of
+// each sample to FILE, one byte per sample and the clips one after another.  Compare that
+// with the source WAV files with tools/adpcm_encode.py --played FILE.
+//
+// The Timer2 overflow interrupt never runs on the host, so its count stays 0 and every
+// call to the sample handler decodes a clip sample.  No voices are sounding, so the clip
+// is all of the output.
+//
+
+extern "C" void toneSynthSample(void);
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: silly_box_clipcheck FILE\n");
+    return 2;
+  }
+  FILE* pFile = fopen(argv[1], "wb");
+  if (pFile == NULL)
+  {
+    perror(argv[1]);
+    return 2;
+  }
+
+  toneSynth::setup();
+  for (uint8_t clip = 0; clip < NUM_CLIPS; clip++)
+  {
+    adpcmClip entry;
+    memcpy_P(&entry, &adpcmClipTable[clip], sizeof(entry));
+
+    toneSynth::playClip(clip);
+    for (uint16_t i = 0; i < entry.numSamples; i++)
+    {
+      toneSynthSample();
+      fputc(OCR2B, pFile);
+    }
+    printf("clip %u: %u samples\n", clip, entry.numSamples);
+  }
+  return fclose(pFile) == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The parts of the Arduino core the sketch uses, for the host build (see hal.h).
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define F_CPU 16000000L
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Flash is just memory on the host
+#define PROGMEM
+#define pgm_read_byte(_P)           (*reinterpret_cast<const uint8_t*> (_P))
+#define pgm_read_word(_P)           (*reinterpret_cast<const uint16_t*> (_P))
+#define pgm_read_dword(_P)          (*reinterpret_cast<const uint32_t*> (_P))
+#define pgm_read_ptr(_P)            (*(void* const*) (_P))
+#define pgm_read_byte_near(_P)      pgm_read_byte(_P)
+#define pgm_read_word_near(_P)      pgm_read_word(_P)
+#define pgm_read_ptr_near(_P)       pgm_read_ptr(_P)
+#define memcpy_P                    memcpy
+
+class __FlashStringHelper;
+#define F(_S)                       (reinterpret_cast<const __FlashStringHelper*> (_S))
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        1
+#define FALLING       2
+#define RISING        3
+
+enum { A0 = 14, A1, A2, A3, A4, A5, A6, A7 };
+
+#define bit(_B)                     (1UL << (_B))
+#define constrain(_A, _L, _H)       ((_A) < (_L) ? (_L) : ((_A) > (_H) ? (_H) : (_A)))
+#define min(_A, _B)                 ((_A) < (_B) ? (_A) : (_B))
+#define max(_A, _B)                 ((_A) > (_B) ? (_A) : (_B))
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh);
+
+// Time, from the virtual clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Pins
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int analogRead(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long durationMs = 0);
+void noTone(uint8_t pin);
+unsigned long pulseIn(uint8_t pin, uint8_t level, unsigned long timeoutUs = 1000000L);
+
+// Same numbers as avr-libc's random() so a seed picks the same groups as on the Nano
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// Interrupts.  Only the external interrupts (pins 2 and 3) are ever called, by 
+// hal::setInput().
+#define digitalPinToInterrupt(_P)   ((_P) == 2 ? 0 : ((_P) == 3 ? 1 : -1))
+void attachInterrupt(uint8_t interrupt, void (*pIsr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+// Serial port.  What the sketch writes goes to hal::setSerialOutput() and what it reads 
+// comes from hal::sendSerial().
+class HardwareSerial
+{
+  public:
+    void begin(unsigned long baud);
+    int available();
+    int read();
+    int availableForWrite();
+    size_t write(uint8_t c);
+    void flush();
+};
+
+extern HardwareSerial Serial;
+
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "avr/pgmspace.h"
+
+// Port mapping, enough for the pin change interrupt set up
+#define digitalPinToPort(_P)        (2)
+#define digitalPinToBitMask(_P)     (static_cast<uint8_t> (1 << ((_P) & 7)))
+#define digitalPinToPCICR(_P)       (&PCICR)
+#define digitalPinToPCICRbit(_P)    (0)
+#define digitalPinToPCMSK(_P)       (&PCMSK0)
+#define digitalPinToPCMSKbit(_P)    ((_P) & 7)
+#define portInputRegister(_P)       (&PINB)
+#define portOutputRegister(_P)      (&PORTC)
@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The Servo library for the host build.  Pulse widths are passed to hal's servo hook.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+
+class Servo
+{
+  public:
+    Servo();
+    uint8_t attach(int pin);
+    uint8_t attach(int pin, int minUs, int maxUs);
+    void detach();
+    bool attached();
+    void write(int value);
+    void writeMicroseconds(int us);
+    int read();
+    int readMicroseconds();
+
+  private:
+    int8_t m_pin;
+    int16_t m_minUs;
+    int16_t m_maxUs;
+    int16_t m_us;
+};
@@ -0,0 +1,46 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The Wire (I2C) library for the host build.  Transfers are counted and dropped.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+class TwoWire
+{
+  public:
+    void begin() {}
+    void setClock(unsigned long) {}
+    void beginTransmission(uint8_t) { m_pending = 1; }
+    size_t write(uint8_t) { m_pending++; return 1; }
+    uint8_t endTransmission(bool = true) { bytes += m_pending; transfers++; m_pending = 0; return 0; }
+
+    unsigned long bytes = 0;        // including the address bytes
+    unsigned long transfers = 0;
+
+  private:
+    unsigned long m_pending = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The ATmega328 registers the sketch uses, as plain variables for the host build.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+
+//
+// Nothing reads or drives these; they are only here so the sketch builds.  The timers 
+// don't count and the interrupt handlers they would call are never called.
+//
+
+#define HOST_REG8(_R)   extern volatile uint8_t _R;
+#define HOST_REG16(_R)  extern volatile uint16_t _R;
+
+HOST_REG8(TCCR0A) HOST_REG8(TCCR0B) HOST_REG8(TCNT0) HOST_REG8(OCR0A) HOST_REG8(OCR0B)
+HOST_REG8(TIMSK0) HOST_REG8(TIFR0)
+HOST_REG8(TCCR1A) HOST_REG8(TCCR1B) HOST_REG16(TCNT1) HOST_REG16(OCR1A) HOST_REG16(OCR1B)
+HOST_REG16(ICR1) HOST_REG8(TIMSK1) HOST_REG8(TIFR1)
+HOST_REG8(TCCR2A) HOST_REG8(TCCR2B) HOST_REG8(TCNT2) HOST_REG8(OCR2A) HOST_REG8(OCR2B)
+HOST_REG8(TIMSK2) HOST_REG8(TIFR2) HOST_REG8(ASSR)
+HOST_REG8(PORTB) HOST_REG8(PORTC) HOST_REG8(PORTD) HOST_REG8(PINB) HOST_REG8(PINC) HOST_REG8(PIND)
+HOST_REG8(DDRB) HOST_REG8(DDRC) HOST_REG8(DDRD)
+HOST_REG8(PCICR) HOST_REG8(PCIFR) HOST_REG8(PCMSK0) HOST_REG8(PCMSK1) HOST_REG8(PCMSK2)
+HOST_REG8(EICRA) HOST_REG8(EIMSK) HOST_REG8(EIFR)
+HOST_REG8(SREG) HOST_REG8(SMCR) HOST_REG8(MCUCR) HOST_REG8(PRR) HOST_REG8(GPIOR0) HOST_REG8(ADCSRA)
+HOST_REG16(SP)
+
+#define RAMSTART  0x100
+#define RAMEND    0x8FF
+
+// Timer 0
+#define WGM00   0
+#define WGM01   1
+#define TOIE0   0
+#define OCIE0A  1
+#define OCIE0B  2
+#define OCF0A   1
+
+// Timer 1
+#define CS10    0
+#define CS11    1
+#define CS12    2
+#define TOIE1   0
+#define OCIE1A  1
+#define OCIE1B  2
+#define OCF1A   1
+#define ICIE1   5
+
+// Timer 2
+#define WGM20   0
+#define WGM21   1
+#define WGM22   3
+#define CS20    0
+#define CS21    1
+#define CS22    2
+#define COM2B0  4
+#define COM2B1  5
+#define COM2A1  7
+#define TOIE2   0
+#define OCIE2A  1
+#define OCIE2B  2
+#define TOV2    0
+
+// External and pin change interrupts
+#define ISC00   0
+#define ISC01   1
+#define INT0    0
+#define INTF0   0
+#define PCIE0   0
+#define PCIE1   1
+#define PCIE2   2
+#define PCIF0   0
+#define PCIF1   1
+#define PCIF2   2
+#define PCINT0  0
+#define PCINT1  1
+#define PCINT18 2
+
+// Ports
+#define PB0     0
+#define PB1     1
+#define PB2     2
+#define PB3     3
+#define PD2     2
+#define PD3     3
@@ -0,0 +1,394 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the hal class and the Arduino core functions of the host build
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdarg.h>
+#include <string>
+#include "hal.h"
+#include "Arduino.h"
+#include "Servo.h"
+#include "Wire.h"
+#include "avr/sleep.h"
+
+static const uint8_t numPins = 22;    // D0 - D13, A0 - A7
+static const uint8_t numInterrupts = 2;
+
+static uint64_t s_us = 0;
+static hal::clockHook s_pClockHook = NULL;
+static hal::servoHook s_pServoHook = NULL;
+static FILE* s_pLog = NULL;
+static FILE* s_pSerialOutput = NULL;
+static std::string s_serialInput;
+
+static uint8_t s_pinMode[numPins];
+static uint8_t s_pinLevel[numPins];
+static int s_analogInput[numPins];
+static void (*s_pIsr[numInterrupts])() = { NULL, NULL };
+static int s_isrMode[numInterrupts];
+
+// Inputs float high until set, like the pull ups the sketch turns on
+static struct pinSetup
+{
+  pinSetup() { memset(s_pinLevel, HIGH, sizeof(s_pinLevel)); }
+} s_pinSetup;
+
+static void logLine(const char* pFormat, ...)
+{
+  if (s_pLog == NULL) return;
+
+  va_list args;
+  va_start(args, pFormat);
+  fprintf(s_pLog, "%10.3f ", s_us / 1000.0);
+  vfprintf(s_pLog, pFormat, args);
+  fputc('\n', s_pLog);
+  va_end(args);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// hal
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+uint64_t hal::getMicros()
+{
+  return s_us;
+}
+
+void hal::advance(uint32_t us)
+{
+  s_us += us;
+  if (s_pClockHook != NULL) s_pClockHook();
+}
+
+void hal::setClockHook(clockHook pHook)
+{
+  s_pClockHook = pHook;
+}
+
+//
+// setInput
+//
+// Sets the level on a pin and calls its interrupt handler if it has one and this is the
+// kind of change it was attached for.
+//
+
+void hal::setInput(uint8_t pin, uint8_t level)
+{
+  if (pin >= numPins || s_pinLevel[pin] == level) return;
+  s_pinLevel[pin] = level;
+
+  int interrupt = digitalPinToInterrupt(pin);
+  if (interrupt < 0 || s_pIsr[interrupt] == NULL) return;
+  int mode = s_isrMode[interrupt];
+  if (mode == CHANGE || (mode == RISING && level == HIGH) || (mode == FALLING && level == LOW))
+  {
+    s_pIsr[interrupt]();
+  }
+}
+
+void hal::setAnalogInput(uint8_t pin, int value)
+{
+  if (pin < numPins) s_analogInput[pin] = value;
+}
+
+void hal::sendSerial(const char* pText)
+{
+  s_serialInput += pText;
+}
+
+void hal::setServoHook(servoHook pHook)
+{
+  s_pServoHook = pHook;
+}
+
+void hal::setLog(FILE* pLog)
+{
+  s_pLog = pLog;
+}
+
+void hal::setSerialOutput(FILE* pFile)
+{
+  s_pSerialOutput = pFile;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Arduino core
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+unsigned long millis()
+{
+  return static_cast<uint32_t> (s_us / 1000);
+}
+
+unsigned long micros()
+{
+  return static_cast<uint32_t> (s_us);
+}
+
+void delay(unsigned long ms)
+{
+  hal::advance(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  hal::advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin < numPins) s_pinMode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+  if (pin >= numPins) return;
+  if (s_pinMode[pin] == OUTPUT && s_pinLevel[pin] != level) logLine("pin %d = %d", pin, level);
+  s_pinLevel[pin] = level;
+}
+
+int digitalRead(uint8_t pin)
+{
+  return (pin < numPins) ? s_pinLevel[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  logLine("pin %d PWM %d", pin, value);
+}
+
+int analogRead(uint8_t pin)
+{
+  return (pin < numPins) ? s_analogInput[pin] : 0;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long)
+{
+  logLine("pin %d tone %u Hz", pin, frequency);
+}
+
+void noTone(uint8_t pin)
+{
+  logLine("pin %d tone off", pin);
+}
+
+// No echo, as if nothing is in range
+unsigned long pulseIn(uint8_t, uint8_t, unsigned long timeoutUs)
+{
+  hal::advance(timeoutUs);
+  return 0;
+}
+
+//
+// random
+//
+// avr-libc's random(), a Park-Miller generator
+//
+
+static uint32_t s_randomState = 1;
+
+static long nextRandom()
+{
+  int32_t x = (s_randomState == 0) ? 123459876L : s_randomState;
+  int32_t hi = x / 127773L;
+  int32_t lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if (x < 0) x += 0x7FFFFFFFL;
+  s_randomState = x;
+  return x;
+}
+
+long random(long howBig)
+{
+  return (howBig == 0) ? 0 : nextRandom() % howBig;
+}
+
+long random(long howSmall, long howBig)
+{
+  return (howSmall >= howBig) ? howSmall : random(howBig - howSmall) + howSmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0) s_randomState = seed;
+}
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh)
+{
+  return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*pIsr)(), int mode)
+{
+  if (interrupt >= numInterrupts) return;
+  s_pIsr[interrupt] = pIsr;
+  s_isrMode[interrupt] = mode;
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+  if (interrupt < numInterrupts) s_pIsr[interrupt] = NULL;
+}
+
+void noInterrupts()
+{
+}
+
+void interrupts()
+{
+}
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long)
+{
+}
+
+int HardwareSerial::available()
+{
+  return s_serialInput.size();
+}
+
+int HardwareSerial::read()
+{
+  if (s_serialInput.empty()) return -1;
+  int c = static_cast<uint8_t> (s_serialInput[0]);
+  s_serialInput.erase(0, 1);
+  return c;
+}
+
+// The transmit buffer always has room, the host keeps up with any baud rate
+int HardwareSerial::availableForWrite()
+{
+  return 63;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (s_pSerialOutput != NULL) fputc(c, s_pSerialOutput);
+  return 1;
+}
+
+void HardwareSerial::flush()
+{
+  if (s_pSerialOutput != NULL) fflush(s_pSerialOutput);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Libraries
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+Servo::Servo() : m_pin(-1), m_minUs(544), m_maxUs(2400), m_us(1500)
+{
+}
+
+uint8_t Servo::attach(int pin)
+{
+  return attach(pin, 544, 2400);
+}
+
+uint8_t Servo::attach(int pin, int minUs, int maxUs)
+{
+  m_pin = pin;
+  m_minUs = minUs;
+  m_maxUs = maxUs;
+  return 0;
+}
+
+void Servo::detach()
+{
+  m_pin = -1;
+}
+
+bool Servo::attached()
+{
+  return m_pin >= 0;
+}
+
+// Like the library, values under the shortest pulse are angles
+void Servo::write(int value)
+{
+  if (value < m_minUs) value = map(constrain(value, 0, 180), 0, 180, m_minUs, m_maxUs);
+  writeMicroseconds(value);
+}
+
+void Servo::writeMicroseconds(int us)
+{
+  us = constrain(us, m_minUs, m_maxUs);
+  if (us == m_us) return;
+  m_us = us;
+  if (m_pin < 0) return;
+  logLine("pin %d servo %d us", m_pin, us);
+  if (s_pServoHook != NULL) s_pServoHook(m_pin, us);
+}
+
+int Servo::read()
+{
+  return map(m_us, m_minUs, m_maxUs, 0, 180);
+}
+
+int Servo::readMicroseconds()
+{
+  return m_us;
+}
+
+TwoWire Wire;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// AVR
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#define HOST_DEFINE_REG8(_R)    volatile uint8_t _R;
+#define HOST_DEFINE_REG16(_R)   volatile uint16_t _R;
+
+HOST_DEFINE_REG8(TCCR0A) HOST_DEFINE_REG8(TCCR0B) HOST_DEFINE_REG8(TCNT0) HOST_DEFINE_REG8(OCR0A)
+HOST_DEFINE_REG8(OCR0B) HOST_DEFINE_REG8(TIMSK0) HOST_DEFINE_REG8(TIFR0)
+HOST_DEFINE_REG8(TCCR1A) HOST_DEFINE_REG8(TCCR1B) HOST_DEFINE_REG16(TCNT1) HOST_DEFINE_REG16(OCR1A)
+HOST_DEFINE_REG16(OCR1B) HOST_DEFINE_REG16(ICR1) HOST_DEFINE_REG8(TIMSK1) HOST_DEFINE_REG8(TIFR1)
+HOST_DEFINE_REG8(TCCR2A) HOST_DEFINE_REG8(TCCR2B) HOST_DEFINE_REG8(TCNT2) HOST_DEFINE_REG8(OCR2A)
+HOST_DEFINE_REG8(OCR2B) HOST_DEFINE_REG8(TIMSK2) HOST_DEFINE_REG8(TIFR2) HOST_DEFINE_REG8(ASSR)
+HOST_DEFINE_REG8(PORTB) HOST_DEFINE_REG8(PORTC) HOST_DEFINE_REG8(PORTD) HOST_DEFINE_REG8(PINB)
+HOST_DEFINE_REG8(PINC) HOST_DEFINE_REG8(PIND) HOST_DEFINE_REG8(DDRB) HOST_DEFINE_REG8(DDRC)
+HOST_DEFINE_REG8(DDRD)
+HOST_DEFINE_REG8(PCICR) HOST_DEFINE_REG8(PCIFR) HOST_DEFINE_REG8(PCMSK0) HOST_DEFINE_REG8(PCMSK1)
+HOST_DEFINE_REG8(PCMSK2) HOST_DEFINE_REG8(EICRA) HOST_DEFINE_REG8(EIMSK) HOST_DEFINE_REG8(EIFR)
+HOST_DEFINE_REG8(SREG) HOST_DEFINE_REG8(SMCR) HOST_DEFINE_REG8(MCUCR) HOST_DEFINE_REG8(PRR)
+HOST_DEFINE_REG8(GPIOR0) HOST_DEFINE_REG8(ADCSRA)
+HOST_DEFINE_REG16(SP)
+
+void set_sleep_mode(uint8_t)
+{
+}
+
+void sleep_enable()
+{
+}
+
+void sleep_disable()
+{
+}
+
+void sleep_cpu()
+{
+  hal::advance(hal::timer0OverflowUs - s_us % hal::timer0OverflowUs);
+}
@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// hal class drives the host build of the sketch: the virtual clock, the input pins and 
+// the serial port, and what the sketch does with its outputs.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! The host build runs the sketch's own sources against Arduino.h, Servo.h etc. from      !!
+// !! this folder.  They stand in for the Arduino core and libraries down to the calls the   !!
+// !! sketch makes (millis(), Servo::write(), digitalRead() ...) and no further: the timer   !!
+// !! interrupts that run the LED PWM and the tone synthesizer never happen, so there is     !!
+// !! no sound or dimming, only what the sequences ask for.  Also remember int is 32 bits    !!
+// !! here and 16 on the Nano.                                                               !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+//
+// Time only passes when it is moved on: by advance() (the caller decides what a pass 
+// through loop() costs), by delay() and by sleep_cpu(), which goes to the next Timer0 
+// overflow like the Nano asleep in IDLE.  So an idle box costs almost nothing to run and 
+// a simulated hour takes well under a second.
+//
+// The clock hook is called every time the clock moves, which is where a test changes the
+// inputs at the right moment.  Inputs read HIGH (as with the pull ups) until set.
+//
+
+class hal
+{
+  public:
+    typedef void (*clockHook)();
+    typedef void (*servoHook)(uint8_t pin, uint16_t pulseUs);
+
+    static const uint16_t timer0OverflowUs = 1024;
+
+  // Methods
+  public:
+    // Virtual clock
+    static uint64_t getMicros();
+    static void advance(uint32_t us);
+    static void setClockHook(clockHook pHook);
+
+    // Inputs
+    static void setInput(uint8_t pin, uint8_t level);
+    static void setAnalogInput(uint8_t pin, int value);
+    static void sendSerial(const char* pText);
+
+    // Outputs.  The log gets a line for every change the sketch makes to an output.
+    static void setServoHook(servoHook pHook);
+    static void setLog(FILE* pLog);
+    static void setSerialOutput(FILE* pFile);
+};
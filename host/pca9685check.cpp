@@ -0,0 +1,95 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// pca9685check checks how the PCA9685 LED backend batches its I2C transfers.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "hal.h"
+#include "Arduino.h"
+#include <Wire.h>
+#include "color.h"
+#include "pca9685leds.h"
+
+//
+//   silly_box_pca9685check
+//
+// Drives pca9685Leds over the Wire mock (see hal/Wire.h) and checks the I2C bytes and 
+// transfers each flush() costs: one transfer from the first changed channel to the last, 
+// unchanged channels in between sent again, a second transfer only past 8 channels and 
+// nothing at all when nothing changed.  pca9685::getBytesSent() must agree with what 
+// the mock saw.  Exits 1 if any of them is wrong.
+//
+
+static bool s_ok = true;
+
+// Flushes and checks the bytes and transfers sent since the last check
+static void checkFlush(const char* pName, unsigned long bytes, unsigned long transfers)
+{
+  static unsigned long lastBytes = 0;
+  static unsigned long lastTransfers = 0;
+
+  pca9685Leds::flush();
+
+  unsigned long sentBytes = Wire.bytes - lastBytes;
+  unsigned long sentTransfers = Wire.transfers - lastTransfers;
+  bool ok = sentBytes == bytes && sentTransfers == transfers && pca9685Leds::getBytesSent() == Wire.bytes;
+
+  printf("%-24s %3lu bytes in %lu transfers%s\n", pName, sentBytes, sentTransfers, ok ? "" : "  WRONG");
+  if (!ok) 
+  {
+    printf("%-24s %3lu bytes in %lu transfers expected, getBytesSent() %lu\n", "", bytes, transfers, 
+           static_cast<unsigned long> (pca9685Leds::getBytesSent()));
+  }
+  s_ok = s_ok && ok;
+  lastBytes = Wire.bytes;
+  lastTransfers = Wire.transfers;
+}
+
+int main()
+{
+  // 5 register writes of 3 bytes, then all 16 channels zeroed in two transfers of 8: 
+  // address, register, OFF of the first, ON and OFF of the other 7
+  pca9685Leds::setup();
+  checkFlush("setup", 5*3 + 2*(4 + 4*7), 7);
+
+  checkFlush("no change", 0, 0);
+
+  // Channel 0 only
+  pca9685Leds::setPixel(0, RGB(255, 0, 0));
+  checkFlush("one channel", 4, 1);
+
+  // Channels 1 and 5, with 2 - 4 sent again in between
+  pca9685Leds::setPixel(0, RGB(255, 255, 0));
+  pca9685Leds::setPixel(1, RGB(0, 0, 255));
+  checkFlush("two channels", 4 + 4*4, 1);
+
+  // The same color again is no change
+  pca9685Leds::setPixel(1, RGB(0, 0, 255));
+  checkFlush("same color", 0, 0);
+
+  // All 15 channels: 0 - 7 then 8 - 14
+  for (uint8_t i = 0; i < pca9685Leds::numPixels; i++) pca9685Leds::setPixel(i, RGB(128, 128, 128));
+  checkFlush("every channel", (4 + 4*7) + (4 + 4*6), 2);
+
+  return s_ok ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// sim runs the sketch on the host against a script of switch changes and serial 
+// commands (see hal.h).
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "hal.h"
+#include "Arduino.h"
+#include "movesequence.h"
+
+//
+//   silly_box_sim [options] event ...
+//
+//   event            MS:on, MS:off (the front switch) or MS:send=TEXT (serial port)
+//   --until MS       when to stop (60000)
+//   --loop-us US     how long each pass through loop() takes (100)
+//   --seed N         the analogRead(A0) value the random numbers are seeded with (0)
+//   --trace FILE     write the serial port to FILE, for tools/trace_decode.py
+//   --log            print every change the sketch makes to an output
+//   --no-strike      the arm doesn't turn the switch off when it reaches it
+//
+// The arm turns the switch off when it gets within strikeDeg of armExtendedAngle, like the
+// real lever (not with SERVO_PCA9685, where the servos aren't driven through Servo).
+//
+
+static const uint8_t switchPin = 2;       // as wired, see silly_box.ino
+static const uint8_t armServoPin = 5;     // as wired, see moveSequence
+static const int strikeDeg = 3;
+
+struct event
+{
+  uint32_t ms;
+  int level;              // switch level, or -1 to send text
+  const char* pText;
+};
+
+static std::vector<event> s_events;
+static size_t s_nextEvent = 0;
+static bool s_strike = true;
+static uint32_t s_switchOnMs = 0;
+static uint32_t s_untilMs = 60000;
+static uint32_t s_passes = 0;
+static std::chrono::steady_clock::time_point s_startTime;
+
+static uint32_t nowMs()
+{
+  return hal::getMicros() / 1000;
+}
+
+static void setSwitch(bool on)
+{
+  if ((digitalRead(switchPin) == LOW) == on) return;
+  if (on) s_switchOnMs = nowMs();
+  hal::setInput(switchPin, on ? LOW : HIGH);
+}
+
+// Stops wherever the sketch has got to, which may be asleep with nothing due for weeks
+static void finish()
+{
+  Serial.flush();
+  double realMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - s_startTime).count();
+  printf("%u passes through loop(), %.1f s simulated in %.1f ms (%.0fx real time)\n", 
+         s_passes, s_untilMs / 1000.0, realMs, s_untilMs / (realMs > 0 ? realMs : 1));
+  exit(0);
+}
+
+// Applies the script as the clock reaches each event
+static void clockHook()
+{
+  if (nowMs() >= s_untilMs) finish();
+
+  while (s_nextEvent < s_events.size() && s_events[s_nextEvent].ms <= nowMs())
+  {
+    const event& e = s_events[s_nextEvent++];
+    if (e.level < 0)
+    {
+      hal::sendSerial(e.pText);
+    }
+    else
+    {
+      printf("%10u switch %s\n", nowMs(), (e.level == LOW) ? "on" : "off");
+      setSwitch(e.level == LOW);
+    }
+  }
+}
+
+static void servoHook(uint8_t pin, uint16_t pulseUs)
+{
+  static const int strikeUs = moveSequence::servoMinUs 
+                            + (moveSequence::servoMaxUs - moveSequence::servoMinUs) 
+                              * (moveSequence::armExtendedAngle + strikeDeg) / 180;
+
+  if (s_strike && pin == armServoPin && pulseUs <= strikeUs && digitalRead(switchPin) == LOW)
+  {
+    printf("%10u arm turned the switch off, %u ms after it went on\n", nowMs(), nowMs() - s_switchOnMs);
+    setSwitch(false);
+  }
+}
+
+static bool parseEvent(const char* pArg, event& e)
+{
+  char* pEnd;
+  e.ms = strtoul(pArg, &pEnd, 10);
+  if (pEnd == pArg || *pEnd != ':') return false;
+  pEnd++;
+  if (strcmp(pEnd, "on") == 0) e.level = LOW;
+  else if (strcmp(pEnd, "off") == 0) e.level = HIGH;
+  else if (strncmp(pEnd, "send=", 5) == 0) { e.level = -1; e.pText = pEnd + 5; }
+  else return false;
+  return true;
+}
+
+void setup();
+void loop();
+
+int main(int argc, char** argv)
+{
+  uint32_t loopUs = 100;
+
+  for (int i = 1; i < argc; i++)
+  {
+    event e;
+    if (strcmp(argv[i], "--until") == 0 && i + 1 < argc) s_untilMs = atol(argv[++i]);
+    else if (strcmp(argv[i], "--loop-us") == 0 && i + 1 < argc) loopUs = atol(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) hal::setAnalogInput(A0, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--log") == 0) hal::setLog(stdout);
+    else if (strcmp(argv[i], "--no-strike") == 0) s_strike = false;
+    else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+    {
+      FILE* pFile = fopen(argv[++i], "wb");
+      if (pFile == NULL) { perror(argv[i]); return 2; }
+      hal::setSerialOutput(pFile);
+    }
+    else if (parseEvent(argv[i], e)) s_events.push_back(e);
+    else
+    {
+      fprintf(stderr, "%s: don't understand '%s', see sim.cpp\n", argv[0], argv[i]);
+      return 2;
+    }
+  }
+
+  hal::setClockHook(clockHook);
+  hal::setServoHook(servoHook);
+
+  s_startTime = std::chrono::steady_clock::now();
+  setup();
+  for (;;)
+  {
+    loop();
+    s_passes++;
+    hal::advance(loopUs);
+  }
+}
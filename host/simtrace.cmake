@@ -0,0 +1,29 @@
+#############################################################################################
+#
+# Runs silly_box_sim, decodes its trace log with tools/trace_decode.py and fails unless the
+# text matches EXPECT (a CMake regular expression) and, if OUTPUT is given, the sim's own
+# output matches OUTPUT.  For the tests in CMakeLists.txt:
+#
+#   cmake -DSIM=silly_box_sim -DDECODE=trace_decode.py -DPYTHON=python3 -DTRACE=t.bin
+#         "-DARGS=--until 30000 1000:on" "-DEXPECT=..." -P simtrace.cmake
+#
+#############################################################################################
+
+separate_arguments(ARGS)
+execute_process(COMMAND ${SIM} ${ARGS} --trace ${TRACE} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+message("${output}")
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "silly_box_sim failed (${result})")
+endif()
+if(OUTPUT AND NOT output MATCHES "${OUTPUT}")
+  message(FATAL_ERROR "The sim's output doesn't match\n  ${OUTPUT}")
+endif()
+
+execute_process(COMMAND ${PYTHON} ${DECODE} ${TRACE} OUTPUT_VARIABLE log RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "trace_decode.py failed (${result})")
+endif()
+
+if(NOT log MATCHES "${EXPECT}")
+  message(FATAL_ERROR "The trace log doesn't match\n  ${EXPECT}\n\n${log}")
+endif()
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// soundcheck checks that each sound sequence sounds from its first note.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "hal.h"
+#include "Arduino.h"
+#include "soundsequence.h"
+
+//
+//   silly_box_soundcheck
+//
+// No sound sequence holds a voice before it is started, and each one that starts with a
+// note has a voice sounding as soon as it is started, the first time and when started 
+// again.  Exits 1 if not.
+//
+
+extern soundSequence soundFussy;
+extern soundSequence soundAnnoyed;
+extern soundSequence soundBackUp;
+extern soundSequence soundStarsStripes;
+extern soundSequence soundStarsStripesLow;
+extern soundSequence soundCharge;
+extern soundSequence soundChargeBass;
+
+static bool anySounding()
+{
+  for (uint8_t i = 0; i < toneSynth::numVoices; i++)
+  {
+    if (toneSynth::isSounding(i)) return true;
+  }
+  return false;
+}
+
+static bool check(const char* pName, soundSequence& aSequence)
+{
+  bool ok = true;
+  for (int start = 1; start <= 2; start++)
+  {
+    aSequence.startSequence(millis());
+    bool sounding = anySounding();
+    printf("%-22s start %d %s\n", pName, start, sounding ? "sounding" : "SILENT");
+    ok = ok && sounding;
+    aSequence.stopSequence();
+    for (uint8_t i = 0; i < toneSynth::numVoices; i++) toneSynth::silence(i);
+    hal::advance(1000000);
+  }
+  return ok;
+}
+
+int main()
+{
+  bool ok = true;
+
+  soundSequence::setup();
+
+  // Every voice is free until a sequence starts
+  uint8_t free = 0;
+  while (toneSynth::claimVoice() != toneSynth::noVoice) free++;
+  for (uint8_t i = 0; i < free; i++) toneSynth::freeVoice(i);
+  printf("%d of %d voices free\n", free, toneSynth::numVoices);
+  ok = free == toneSynth::numVoices;
+
+  ok = check("soundFussy", soundFussy) && ok;
+  ok = check("soundAnnoyed", soundAnnoyed) && ok;
+  ok = check("soundBackUp", soundBackUp) && ok;
+  ok = check("soundStarsStripes", soundStarsStripes) && ok;
+  ok = check("soundStarsStripesLow", soundStarsStripesLow) && ok;
+  ok = check("soundCharge", soundCharge) && ok;
+  ok = check("soundChargeBass", soundChargeBass) && ok;
+  return ok ? 0 : 1;
+}
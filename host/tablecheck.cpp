@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// tablecheck checks the sequence tables against the limits of the sequence class.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "hal.h"
+#include "Arduino.h"
+#include "group.h"
+#include "action.h"
+
+//
+//   silly_box_tablecheck
+//
+// Walks every group's sequence tables and reports the deepest each one nests LOOPs and 
+// CALLs.  A group deeper than sequence::vmStackDepth would have a sequence stopped part way
+// through on the box, so that makes the exit status 1.  So does a table of nothing but flow
+// control that doesn't stop when it is started (sequence::maxFlowSteps).
+//
+
+extern group switchGroupTable[];
+extern const int numSwitchGroups;
+extern group proxGroupTable[];
+extern const int numProxGroups;
+
+// A LOOP with nothing in it never gets to an action
+static const uint8_t emptyLoopTbl[] PROGMEM = 
+{
+  SEQ_LOOP(LOOP_FOREVER),
+  SEQ_NEXT(),
+  SEQ_END()
+};
+
+static bool checkRunaway()
+{
+  sequence emptyLoop(emptyLoopTbl, sequence::PRIMARY_SEQ);
+  emptyLoop.startSequence(millis());
+  bool ok = emptyLoop.getSeqState() == sequence::SEQ_COMPLETE;
+  printf("empty LOOP_FOREVER %s\n", ok ? "stopped" : "still executing");
+  return ok;
+}
+
+static bool check(const char* pName, int index, group& aGroup)
+{
+  uint8_t depth = aGroup.getNestingDepth();
+  bool ok = depth <= sequence::vmStackDepth;
+  printf("%s%-2d nesting %d%s\n", pName, index, depth, ok ? "" : " is deeper than sequence::vmStackDepth");
+  return ok;
+}
+
+int main()
+{
+  bool ok = true;
+
+  for (int i = 0; i < numSwitchGroups; i++) ok = check("S", i, switchGroupTable[i]) && ok;
+  for (int i = 0; i < numProxGroups; i++) ok = check("P", i, proxGroupTable[i]) && ok;
+  ok = checkRunaway() && ok;
+  return ok ? 0 : 1;
+}
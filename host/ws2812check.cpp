@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ws2812check checks the bit stream ws2812Strip sends to the strip.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <vector>
+#include "hal.h"
+#include "Arduino.h"
+#include "color.h"
+#include "ws2812.h"
+
+//
+//   silly_box_ws2812check
+//
+// Sends a frame through the mock wire (see ws2812Strip::s_pMockWire) and checks that every
+// bit is high for t0hCycles or t1hCycles, lasts bitCycles and carries the right value: the
+// blank frame setup() sends, then a single pixel's colour through the gamma table along 
+// with the unchanged pixels ahead of it.  Exits 1 on the first wrong bit.
+//
+
+struct wireBit
+{
+  uint8_t highCycles;
+  uint8_t totalCycles;
+};
+
+static std::vector<wireBit> s_bits;
+
+static void mockWire(uint8_t highCycles, uint8_t totalCycles)
+{
+  s_bits.push_back({highCycles, totalCycles});
+}
+
+// Flushes the frame buffer and checks the bits against the pixels in 'pGrb'
+static bool checkFrame(const char* pName, const uint8_t* pGrb, size_t numBytes)
+{
+  s_bits.clear();
+
+  // Past the latch time and with the next servo interrupt (OCR1A) a whole frame away
+  hal::advance(1000);
+  OCR1A = TCNT1 + 40000;
+  TIFR1 = 0;
+  if (!ws2812Strip::flush())
+  {
+    printf("%s: flush() didn't send\n", pName);
+    return false;
+  }
+
+  if (s_bits.size() != numBytes * 8)
+  {
+    printf("%s: %zu bits sent, expected %zu\n", pName, s_bits.size(), numBytes * 8);
+    return false;
+  }
+
+  for (size_t i = 0; i < s_bits.size(); i++)
+  {
+    uint8_t byte = pgm_read_byte_near(&gammaTable[pGrb[i / 8]]);
+    bool one = (byte & (0x80 >> (i % 8))) != 0;
+    uint8_t highCycles = one ? ws2812Strip::t1hCycles : ws2812Strip::t0hCycles;
+
+    if (s_bits[i].highCycles != highCycles || s_bits[i].totalCycles != ws2812Strip::bitCycles)
+    {
+      printf("%s: bit %zu (a %d) high %u of %u cycles, expected %u of %u\n", pName, i, one,
+             s_bits[i].highCycles, s_bits[i].totalCycles, highCycles, ws2812Strip::bitCycles);
+      return false;
+    }
+  }
+  printf("%s: %zu bits OK\n", pName, s_bits.size());
+  return true;
+}
+
+int main()
+{
+  static const uint8_t pixel = 3;
+  static const uint32_t color = RGB(0x5A, 0xC3, 0x0F);
+  uint8_t grb[ws2812Strip::numPixels * 3] = {};
+
+  ws2812Strip::s_pMockWire = mockWire;
+  ws2812Strip::setup();
+  if (!checkFrame("blank frame", grb, sizeof(grb))) return 1;
+
+  ws2812Strip::setPixel(pixel, color);
+  grb[pixel * 3] = static_cast<uint8_t> (color >> 8);
+  grb[pixel * 3 + 1] = static_cast<uint8_t> (color >> 16);
+  grb[pixel * 3 + 2] = static_cast<uint8_t> (color);
+  if (!checkFrame("one pixel", grb, (pixel + 1) * 3)) return 1;
+
+  // Nothing changed, nothing sent
+  if (!checkFrame("no change", grb, 0)) return 1;
+  return 0;
+}
@@ -26,154 +26,304 @@
 #pragma once
 #include "Arduino.h"
 
-enum actionType
+// Opcodes are numbered densely from 0 and are a byte, so tables indexed by opcode (like
+// sequence::actionFormat) stay small and switch statements on them compile to jump tables
+enum actionType : uint8_t
 {
 //  Action Enum                                      Data1                      Data2                         Data3   
 //  ---------------------------------------------------------------------------------------------------------------------------------------
     // Generic Actions
-    ACTION_DELAY,                                 // Delay (ms)                 Not Used                      Not Used
+    ACTION_DELAY,                                 // Delay (ms) [16]            Not Used                      Not Used
+
+    // Flow Control Actions (see "Flow control" below)
+    ACTION_LOOP,                                  // Count or LOOP_FOREVER [8]  Not Used                      Not Used
+    ACTION_NEXT,                                  // Not Used                   Not Used                      Not Used
+    ACTION_CALL,                                  // Subroutine index [8]       Not Used                      Not Used
+    ACTION_RET,                                   // Not Used                   Not Used                      Not Used
+    ACTION_JUMP,                                  // Subroutine index [8]       Not Used                      Not Used
+    ACTION_BRANCH_RANDOM,                         // Percent chance [8]         Subroutine index [8]          Not Used
     ACTION_LAST_GENERIC,                          // [placeholder only]
     
     // Move Actions
     ACTION_OPEN_LID,                              // Not Used                   Not Used                      Not Used
     ACTION_CLOSE_LID,                             // Not Used                   Not Used                      Not Used
-    ACTION_MOVE_LID,                              // Start angle                End angle                     Delay(ms) between degrees  
-    ACTION_PEEK_LID_FROM_CLOSE,                   // Peek angle offset degrees  Delay(ms) between degrees
-    ACTION_CLOSE_LID_FROM_PEEK,                   // Peek angle offset degrees  Delay(ms) between degrees
-    ACTION_OPEN_LID_FROM_CLOSE,                   // Delay(ms) between degrees  Not Used                      Not Used
-    ACTION_CLOSE_LID_FROM_OPEN,                   // Delay(ms) between degrees  Not Used                      Not Used
+    ACTION_MOVE_LID,                              // Start angle [8]            End angle [8]                 Delay(ms) between degrees [8]
+    ACTION_PEEK_LID_FROM_CLOSE,                   // Peek angle offset [8]      Delay(ms) between degrees [8]
+    ACTION_CLOSE_LID_FROM_PEEK,                   // Peek angle offset [8]      Delay(ms) between degrees [8]
+    ACTION_OPEN_LID_FROM_CLOSE,                   // Delay(ms) btwn degrees [8] Not Used                      Not Used
+    ACTION_CLOSE_LID_FROM_OPEN,                   // Delay(ms) btwn degrees [8] Not Used                      Not Used
     ACTION_EXTEND_ARM,                            //
     ACTION_RETRACT_ARM,                           //
-    ACTION_MOVE_ARM,                              // Start angle                End angle                     Delay(ms) between degrees  
-    ACTION_EXTEND_ARM_FROM_RETRACTED,             // Delay(ms) between degrees  Not Used                      Not Used
-    ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED,      // Delay(ms) between degrees  Not Used                      Not Used
-    ACTION_RETRACT_ARM_FROM_EXTENDED,             // Delay(ms) between degrees  Not Used                      Not Used
+    ACTION_MOVE_ARM,                              // Start angle [8]            End angle [8]                 Delay(ms) between degrees [8]
+    ACTION_EXTEND_ARM_FROM_RETRACTED,             // Delay(ms) btwn degrees [8] Not Used                      Not Used
+    ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED,      // Delay(ms) btwn degrees [8] Not Used                      Not Used
+    ACTION_RETRACT_ARM_FROM_EXTENDED,             // Delay(ms) btwn degrees [8] Not Used                      Not Used
+    ACTION_PROFILE_LID,                           // Start angle [8]            End angle [8]                 PROFILE_XXX (see below) [8]
+    ACTION_PROFILE_ARM,                           // Start angle [8]            End angle [8]                 PROFILE_XXX (see below) [8]
+    ACTION_PROFILE_LID_ARM,                       // Lid start | end << 8 [16]  Arm start | end << 8 [16]     PROFILE_XXX | phase << 8 [16]
+    ACTION_PROFILE_ARM_LID,                       // Arm start | end << 8 [16]  Lid start | end << 8 [16]     PROFILE_XXX | phase << 8 [16]
   
     // LED Actions
-    ACTION_SET_LED,                               // LEFT, RIGHT, or ALL_LEDS   LED color (from color.h)      Not Used
-    ACTION_TRANS_LED,                             // LEFT, RIGHT, or ALL_LEDS   End LED color (from color.h)  Delay(ms) between increments           
+    ACTION_SET_LED,                               // LED_RANGE (see below) [16] LED color [24]                Not Used
+    ACTION_TRANS_LED,                             // LED_RANGE (see below) [16] End LED color [24]            Fade duration (ms) [16]
     
     // Sound Actions
-    PITCH_B0  = 31,                               // NOTE_XXX (see below)       Not Used                      Not Used
-    PITCH_C1  = 33,                               // ^^^^^^^^^^^^^^^^^^^^ Same for all PITCH_XXX
-    PITCH_CS1 = 35,
-    PITCH_D1  = 37,
-    PITCH_DS1 = 39,
-    PITCH_EF1 = 39,                             
-    PITCH_E1  = 41,
-    PITCH_F1  = 44,
-    PITCH_FS1 = 46,
-    PITCH_G1  = 49,
-    PITCH_GS1 = 52,
-    PITCH_AF1 = 52,
-    PITCH_A1  = 55,
-    PITCH_AS1 = 58,
-    PITCH_BF1 = 58,
-    PITCH_B1  = 62,
-    PITCH_C2  = 65,
-    PITCH_CS2 = 69,
-    PITCH_D2  = 73,
-    PITCH_DS2 = 78,
-    PITCH_EF2 = 78,
-    PITCH_E2  = 82,
-    PITCH_F2  = 87,
-    PITCH_FS2 = 93,
-    PITCH_GF2 = 93,
-    PITCH_G2  = 98,
-    PITCH_GS2 = 104,
-    PITCH_AF2 = 104,
-    PITCH_A2  = 110,
-    PITCH_AS2 = 117,
-    PITCH_BF2 = 117,
-    PITCH_B2  = 123,
-    PITCH_C3  = 131,
-    PITCH_CS3 = 139,
-    PITCH_D3  = 147,
-    PITCH_DS3 = 156,
-    PITCH_EF3 = 156,
-    PITCH_E3  = 165,
-    PITCH_F3  = 175,
-    PITCH_FS3 = 185,
-    PITCH_GF3 = 185,
-    PITCH_G3  = 196,
-    PITCH_GS3 = 208,
-    PITCH_AF3 = 208,
-    PITCH_A3  = 220,
-    PITCH_AS3 = 233,
-    PITCH_BF3 = 233,
-    PITCH_B3  = 247,
-    PITCH_C4  = 262,
-    PITCH_CS4 = 277,
-    PITCH_D4  = 294,
-    PITCH_DS4 = 311,
-    PITCH_EF4 = 311,
-    PITCH_E4  = 330,
-    PITCH_F4  = 349,
-    PITCH_FS4 = 370,
-    PITCH_GF4 = 370,
-    PITCH_G4  = 392,
-    PITCH_GS4 = 415,
-    PITCH_AF4 = 415,
-    PITCH_A4  = 440,
-    PITCH_AS4 = 466,
-    PITCH_BF4 = 466,
-    PITCH_B4  = 494,
-    PITCH_C5  = 523,
-    PITCH_CS5 = 554,
-    PITCH_D5  = 587,
-    PITCH_DS5 = 622,
-    PITCH_EF5 = 622,
-    PITCH_E5  = 659,
-    PITCH_F5  = 698,
-    PITCH_FS5 = 740,
-    PITCH_G5  = 784,
-    PITCH_GS5 = 831,
-    PITCH_AF5 = 831,
-    PITCH_A5  = 880,
-    PITCH_AS5 = 932,
-    PITCH_BF5 = 932,
-    PITCH_B5  = 988,
-    PITCH_C6  = 1047,
-    PITCH_CS6 = 1109,
-    PITCH_D6  = 1175,
-    PITCH_DS6 = 1245,
-    PITCH_EF6 = 1245,
-    PITCH_E6  = 1319,
-    PITCH_F6  = 1397,
-    PITCH_FS6 = 1480,
-    PITCH_G6  = 1568,
-    PITCH_GS6 = 1661,
-    PITCH_AF6 = 1661,
-    PITCH_A6  = 1760,
-    PITCH_AS6 = 1865,
-    PITCH_BF6 = 1865,
-    PITCH_B6  = 1976,
-    PITCH_C7  = 2093,
-    PITCH_CS7 = 2217,
-    PITCH_D7  = 2349,
-    PITCH_DS7 = 2489,
-    PITCH_EF7 = 2489,
-    PITCH_E7  = 2637,
-    PITCH_F7  = 2794,
-    PITCH_FS7 = 2960,
-    PITCH_G7  = 3136,
-    PITCH_GS7 = 3322,
-    PITCH_AF7 = 3322,
-    PITCH_A7  = 3520,
-    PITCH_AS7 = 3729,
-    PITCH_BF7 = 3729,
-    PITCH_B7  = 3951,
-    PITCH_C8  = 4186,
-    PITCH_CS8 = 4435,
-    PITCH_D8  = 4699,
-    PITCH_DS8 = 4978,
-    PITCH_REST,
-    TEMPO,                                        // TEMPO_XXX (see below)        Not Used                      Not Used
-    NEW_TEMPO = TEMPO,                            // TEMPO_XXX (see below)        Not Used                      Not Used
-    ARTICULATE,                                   // ARTICULATE_XXX (see below)   Not Used                      Not Used
+    ACTION_NOTE,                                  // PITCH_XXX (see below) [8]  Sounding (ms) [16]            Length (ms) [16]
+    ACTION_PLAY_SAMPLE,                           // CLIP_XXX (see clips.h) [8] Not Used                      Not Used
     ACTION_END
 };
 
+//
+// Compact table encoding
+//
+// Sequence tables are stored as a stream of bytes rather than an array of fixed size 
+// entries.  Each action is a 1 byte opcode (the actionType above) followed only by the 
+// operands that action uses, each sized as shown in [brackets] in the table above.  
+// Multi-byte operands are little endian.  Use the SEQ_XXX macros below to build tables
+// so that the operand sizes always match what the decoder in sequence.cpp expects.
+//
+
+// Operand widths.  The per action operand layout lives in sequence::actionFormat.
+#define OPND_NONE 0
+#define OPND_8    1
+#define OPND_16   2
+#define OPND_24   3
+#define ACTION_FORMAT(_D1, _D2, _D3) ((_D1) | ((_D2) << 2) | ((_D3) << 4))
+
+#define SEQ_U8(_X)  static_cast<uint8_t>(_X)
+#define SEQ_U16(_X) static_cast<uint8_t>(_X), static_cast<uint8_t>((_X) >> 8)
+#define SEQ_U24(_X) static_cast<uint8_t>(_X), static_cast<uint8_t>((_X) >> 8), static_cast<uint8_t>((_X) >> 16)
+
+// Generic actions
+#define SEQ_DELAY(_MS)                              ACTION_DELAY, SEQ_U16(_MS)
+#define SEQ_END()                                   ACTION_END
+
+//
+// Flow control
+//
+// Flow control actions are handled entirely by the sequence base class and take no time.
+//
+//   SEQ_LOOP(n) ... SEQ_NEXT()   Execute the actions in between n times (LOOP_FOREVER repeats
+//                                until the sequence is stopped).  Loops may be nested.
+//   SEQ_CALL(sub)                Execute subroutine 'sub' then continue with the next action.
+//   SEQ_RET()                    Return from a subroutine.  Every subroutine ends with this.
+//   SEQ_JUMP(sub)                Continue execution at subroutine 'sub' without returning.
+//   SEQ_BRANCH_RANDOM(pct, sub)  SEQ_CALL(sub) pct percent of the time, otherwise do nothing.
+//
+// 'sub' is an index into 'seqSubroutineTable' (see tables.cpp).  LOOP and CALL nest up to
+// sequence::vmStackDepth deep (any deeper stops the sequence, the host build's "tables" test
+// checks this); a loop body must contain at least one action that isn't flow control, and
+// so must a chain of JUMPs that comes back on itself (one that doesn't is stopped after
+// sequence::maxFlowSteps flow control actions in a row).
+//
+#define SEQ_LOOP(_COUNT)                            ACTION_LOOP, SEQ_U8(_COUNT)
+#define SEQ_NEXT()                                  ACTION_NEXT
+#define SEQ_CALL(_SUB)                              ACTION_CALL, SEQ_U8(_SUB)
+#define SEQ_RET()                                   ACTION_RET
+#define SEQ_JUMP(_SUB)                              ACTION_JUMP, SEQ_U8(_SUB)
+#define SEQ_BRANCH_RANDOM(_PCT, _SUB)               ACTION_BRANCH_RANDOM, SEQ_U8(_PCT), SEQ_U8(_SUB)
+
+const uint8_t LOOP_FOREVER = 0;
+
+// Move actions
+#define SEQ_OPEN_LID()                              ACTION_OPEN_LID
+#define SEQ_CLOSE_LID()                             ACTION_CLOSE_LID
+#define SEQ_MOVE_LID(_START, _END, _DEG_MS)         ACTION_MOVE_LID, SEQ_U8(_START), SEQ_U8(_END), SEQ_U8(_DEG_MS)
+#define SEQ_PEEK_LID_FROM_CLOSE(_PEEK, _DEG_MS)     ACTION_PEEK_LID_FROM_CLOSE, SEQ_U8(_PEEK), SEQ_U8(_DEG_MS)
+#define SEQ_CLOSE_LID_FROM_PEEK(_PEEK, _DEG_MS)     ACTION_CLOSE_LID_FROM_PEEK, SEQ_U8(_PEEK), SEQ_U8(_DEG_MS)
+#define SEQ_OPEN_LID_FROM_CLOSE(_DEG_MS)            ACTION_OPEN_LID_FROM_CLOSE, SEQ_U8(_DEG_MS)
+#define SEQ_CLOSE_LID_FROM_OPEN(_DEG_MS)            ACTION_CLOSE_LID_FROM_OPEN, SEQ_U8(_DEG_MS)
+#define SEQ_EXTEND_ARM()                            ACTION_EXTEND_ARM
+#define SEQ_RETRACT_ARM()                           ACTION_RETRACT_ARM
+#define SEQ_MOVE_ARM(_START, _END, _DEG_MS)         ACTION_MOVE_ARM, SEQ_U8(_START), SEQ_U8(_END), SEQ_U8(_DEG_MS)
+#define SEQ_EXTEND_ARM_FROM_RETRACTED(_DEG_MS)      ACTION_EXTEND_ARM_FROM_RETRACTED, SEQ_U8(_DEG_MS)
+#define SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(_DEG_MS) ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, SEQ_U8(_DEG_MS)
+#define SEQ_RETRACT_ARM_FROM_EXTENDED(_DEG_MS)      ACTION_RETRACT_ARM_FROM_EXTENDED, SEQ_U8(_DEG_MS)
+#define SEQ_PROFILE_LID(_START, _END, _PROFILE)     ACTION_PROFILE_LID, SEQ_U8(_START), SEQ_U8(_END), SEQ_U8(_PROFILE)
+#define SEQ_PROFILE_ARM(_START, _END, _PROFILE)     ACTION_PROFILE_ARM, SEQ_U8(_START), SEQ_U8(_END), SEQ_U8(_PROFILE)
+#define SEQ_PROFILE_LID_ARM(_LID_START, _LID_END, _ARM_START, _ARM_END, _PROFILE, _PHASE) \
+  ACTION_PROFILE_LID_ARM, SEQ_U8(_LID_START), SEQ_U8(_LID_END), SEQ_U8(_ARM_START), SEQ_U8(_ARM_END), SEQ_U8(_PROFILE), SEQ_U8(_PHASE)
+#define SEQ_PROFILE_ARM_LID(_ARM_START, _ARM_END, _LID_START, _LID_END, _PROFILE, _PHASE) \
+  ACTION_PROFILE_ARM_LID, SEQ_U8(_ARM_START), SEQ_U8(_ARM_END), SEQ_U8(_LID_START), SEQ_U8(_LID_END), SEQ_U8(_PROFILE), SEQ_U8(_PHASE)
+
+//
+// Motion profiles
+//
+// The legacy move actions step the servo 1 degree at a time at a constant speed.  The 
+// PROFILE actions instead accelerate up to a speed limit and decelerate into the end angle
+// (trapezoid), or follow an S-shaped ease in/out curve, and position the servo to a fraction
+// of a degree.  The speed and acceleration limits of each profile are in 
+// moveSequence::motionProfiles (movesequence.cpp).  A PROFILE_ARM move that ends at 
+// moveSequence::armExtendedAngle counts as an attempt to turn the switch off.
+//
+// PROFILE_LID_ARM and PROFILE_ARM_LID move both servos at once.  The first servo named leads
+// and the other follows, starting once the leader has moved 'phase' degrees (0 starts them
+// together).  The follower is slowed down to arrive with the leader when it would otherwise 
+// get there first.  For example, to open the lid and strike the switch in one motion:
+//
+//   SEQ_PROFILE_LID_ARM(lidClosedAngle, lidOpenedAngle, armRetractedAngle, armExtendedAngle,
+//                       PROFILE_STRIKE, 20)
+//
+// Every move (legacy or PROFILE) starts from wherever the servo actually is, so the start 
+// angles of MOVE_XXX and PROFILE_XXX are only there to make the tables readable.  A move 
+// that follows a stopped group blends on from the pose that group left the servos in.
+//
+enum profileType
+{
+    PROFILE_STRIKE,   // Trapezoid, as fast as the arm can go and still land cleanly
+    PROFILE_BRISK,    // Trapezoid, quick but not violent
+    PROFILE_EASE,     // Ease in/out
+    PROFILE_GENTLE    // Slow ease in/out
+};
+
+//
+// LED actions
+//
+// LED actions apply to a range of pixels, first to last inclusive, numbered from 0.  A last
+// pixel past the end of the LEDs means up to the end.  ledSequence::LEFT, RIGHT and ALL_LEDS
+// are ranges for the common cases.
+//
+#define LED_RANGE(_FIRST, _LAST)                    ((_FIRST) | ((_LAST) << 8))
+
+#define SEQ_SET_LED(_LEDS, _COLOR)                  ACTION_SET_LED, SEQ_U16(_LEDS), SEQ_U24(_COLOR)
+#define SEQ_TRANS_LED(_LEDS, _COLOR, _FADE_MS)      ACTION_TRANS_LED, SEQ_U16(_LEDS), SEQ_U24(_COLOR), SEQ_U16(_FADE_MS)
+
+// Sound actions
+//
+// A song's tempo and articulation are settled when the tables are compiled.  Each note 
+// carries how long it sounds for and how long it lasts in ms (see songStyle below) so 
+// playing it takes no arithmetic.  Give each song a style and name it in every note and 
+// rest:
+//
+//   constexpr songStyle chargeStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+//
+//   SEQ_NOTE(chargeStyle, PITCH_G3, NOTE_8TH),
+//   SEQ_REST(chargeStyle, NOTE_QTR),
+//
+#define SEQ_NOTE(_STYLE, _PITCH, _NOTE)             ACTION_NOTE, SEQ_U8(_PITCH), SEQ_U16((_STYLE).soundingMs(_NOTE)), SEQ_U16((_STYLE).lengthMs(_NOTE))
+#define SEQ_REST(_STYLE, _NOTE)                     SEQ_DELAY((_STYLE).lengthMs(_NOTE))
+// Plays a recorded clip (see tools/adpcm_encode.py) and waits for it to finish.  Clips play
+// alongside the notes of any sound sequence, one clip at a time.
+#define SEQ_PLAY_SAMPLE(_CLIP)                      ACTION_PLAY_SAMPLE, SEQ_U8(_CLIP)
+
+// PITCH (MIDI note number, middle C is PITCH_C4 = 60)
+enum pitchType : uint8_t
+{
+    PITCH_B0  = 23,
+    PITCH_C1  = 24,
+    PITCH_CS1 = 25,
+    PITCH_D1  = 26,
+    PITCH_DS1 = 27,
+    PITCH_EF1 = 27,
+    PITCH_E1  = 28,
+    PITCH_F1  = 29,
+    PITCH_FS1 = 30,
+    PITCH_G1  = 31,
+    PITCH_GS1 = 32,
+    PITCH_AF1 = 32,
+    PITCH_A1  = 33,
+    PITCH_AS1 = 34,
+    PITCH_BF1 = 34,
+    PITCH_B1  = 35,
+    PITCH_C2  = 36,
+    PITCH_CS2 = 37,
+    PITCH_D2  = 38,
+    PITCH_DS2 = 39,
+    PITCH_EF2 = 39,
+    PITCH_E2  = 40,
+    PITCH_F2  = 41,
+    PITCH_FS2 = 42,
+    PITCH_GF2 = 42,
+    PITCH_G2  = 43,
+    PITCH_GS2 = 44,
+    PITCH_AF2 = 44,
+    PITCH_A2  = 45,
+    PITCH_AS2 = 46,
+    PITCH_BF2 = 46,
+    PITCH_B2  = 47,
+    PITCH_C3  = 48,
+    PITCH_CS3 = 49,
+    PITCH_D3  = 50,
+    PITCH_DS3 = 51,
+    PITCH_EF3 = 51,
+    PITCH_E3  = 52,
+    PITCH_F3  = 53,
+    PITCH_FS3 = 54,
+    PITCH_GF3 = 54,
+    PITCH_G3  = 55,
+    PITCH_GS3 = 56,
+    PITCH_AF3 = 56,
+    PITCH_A3  = 57,
+    PITCH_AS3 = 58,
+    PITCH_BF3 = 58,
+    PITCH_B3  = 59,
+    PITCH_C4  = 60,
+    PITCH_CS4 = 61,
+    PITCH_D4  = 62,
+    PITCH_DS4 = 63,
+    PITCH_EF4 = 63,
+    PITCH_E4  = 64,
+    PITCH_F4  = 65,
+    PITCH_FS4 = 66,
+    PITCH_GF4 = 66,
+    PITCH_G4  = 67,
+    PITCH_GS4 = 68,
+    PITCH_AF4 = 68,
+    PITCH_A4  = 69,
+    PITCH_AS4 = 70,
+    PITCH_BF4 = 70,
+    PITCH_B4  = 71,
+    PITCH_C5  = 72,
+    PITCH_CS5 = 73,
+    PITCH_D5  = 74,
+    PITCH_DS5 = 75,
+    PITCH_EF5 = 75,
+    PITCH_E5  = 76,
+    PITCH_F5  = 77,
+    PITCH_FS5 = 78,
+    PITCH_G5  = 79,
+    PITCH_GS5 = 80,
+    PITCH_AF5 = 80,
+    PITCH_A5  = 81,
+    PITCH_AS5 = 82,
+    PITCH_BF5 = 82,
+    PITCH_B5  = 83,
+    PITCH_C6  = 84,
+    PITCH_CS6 = 85,
+    PITCH_D6  = 86,
+    PITCH_DS6 = 87,
+    PITCH_EF6 = 87,
+    PITCH_E6  = 88,
+    PITCH_F6  = 89,
+    PITCH_FS6 = 90,
+    PITCH_G6  = 91,
+    PITCH_GS6 = 92,
+    PITCH_AF6 = 92,
+    PITCH_A6  = 93,
+    PITCH_AS6 = 94,
+    PITCH_BF6 = 94,
+    PITCH_B6  = 95,
+    PITCH_C7  = 96,
+    PITCH_CS7 = 97,
+    PITCH_D7  = 98,
+    PITCH_DS7 = 99,
+    PITCH_EF7 = 99,
+    PITCH_E7  = 100,
+    PITCH_F7  = 101,
+    PITCH_FS7 = 102,
+    PITCH_G7  = 103,
+    PITCH_GS7 = 104,
+    PITCH_AF7 = 104,
+    PITCH_A7  = 105,
+    PITCH_AS7 = 106,
+    PITCH_BF7 = 106,
+    PITCH_B7  = 107,
+    PITCH_C8  = 108,
+    PITCH_CS8 = 109,
+    PITCH_D8  = 110,
+    PITCH_DS8 = 111
+};
+
 // TEMPO
 const uint32_t TEMPO_PRESTO = 200; // BPM
 const uint32_t TEMPO_ALLEGRO = 150; 
@@ -199,3 +349,16 @@ const uint32_t NOTE_32ND = 1;
 const uint32_t ARTICULATE_TENUDO = 100; // Percent of note length
 const uint32_t ARTICULATE_STACCATO = 80;
 const uint32_t ARTICULATE_LEGATO = 95;
+
+// Tempo and articulation of a song, for SEQ_NOTE and SEQ_REST
+struct songStyle
+{
+  uint16_t noteMs;        // length of a 32nd note
+  uint8_t articulation;   // ARTICULATE_XXX
+
+  constexpr songStyle(uint32_t tempo, uint32_t articulate)
+    : noteMs(60000/tempo/NOTE_QTR), articulation(articulate) {}
+
+  constexpr uint16_t lengthMs(uint32_t note) const { return noteMs*note; }
+  constexpr uint16_t soundingMs(uint32_t note) const { return noteMs*note*articulation/100; }
+};
@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// IMA-ADPCM voice clips for SEQ_PLAY_SAMPLE (see tonesynth.h)
+//
+// Generated by tools/adpcm_encode.py from grumble.wav.  Don't edit, run it again.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "clips.h"
+
+// grumble.wav: 3529 samples, 449 ms
+static const uint8_t clipGrumble[] PROGMEM =
+{
+  0x70, 0x77, 0x96, 0x99, 0x9a, 0x09, 0x42, 0x23, 0x80, 0x99, 0xa8, 0xa0, 0x88, 0x9b, 0xdb, 0xc8,
+  0xaa, 0x9d, 0xdb, 0xc8, 0x9a, 0x9d, 0xcc, 0xea, 0x8a, 0x71, 0x26, 0xa1, 0xdc, 0xdd, 0xbd, 0x1a,
+  0x77, 0x03, 0x98, 0x99, 0x89, 0x88, 0x00, 0x10, 0x80, 0x90, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88,
+  0x89, 0x99, 0xb8, 0x89, 0x9b, 0xbb, 0xfa, 0xcb, 0x8d, 0x50, 0x37, 0x92, 0xcc, 0xce, 0xdd, 0x0a,
+  0x73, 0x17, 0x90, 0x89, 0x89, 0x88, 0x80, 0x01, 0x80, 0x80, 0x88, 0x08, 0x88, 0x80, 0x88, 0x88,
+  0x88, 0x98, 0x98, 0x98, 0x89, 0xb9, 0xd8, 0xba, 0x8e, 0x40, 0x47, 0x82, 0xbc, 0xbf, 0xde, 0x8a,
+  0x74, 0x15, 0x88, 0x99, 0x89, 0x88, 0x08, 0x01, 0x80, 0x80, 0x88, 0x08, 0x88, 0x80, 0x88, 0x88,
+  0x98, 0x90, 0x98, 0x89, 0x89, 0xb9, 0xc8, 0xcb, 0x9c, 0x61, 0x27, 0x83, 0xcc, 0xcd, 0xdd, 0x8a,
+  0x73, 0x27, 0x88, 0x99, 0x98, 0x88, 0x80, 0x10, 0x80, 0x80, 0x88, 0x08, 0x88, 0x80, 0x88, 0x88,
+  0x88, 0x90, 0x88, 0x89, 0x89, 0xa8, 0xb8, 0xbb, 0x9f, 0x20, 0x67, 0x02, 0xca, 0xdc, 0xdd, 0x9b,
+  0x72, 0x27, 0x80, 0x99, 0x89, 0x88, 0x08, 0x00, 0x00, 0x80, 0x88, 0x88, 0x80, 0x88, 0x08, 0x88,
+  0x98, 0x90, 0x88, 0x89, 0xa8, 0x88, 0x8a, 0xac, 0xea, 0x89, 0x72, 0x26, 0xa1, 0xcc, 0xdd, 0xbd,
+  0x19, 0x77, 0x02, 0x88, 0x8a, 0x89, 0x88, 0x00, 0x10, 0x08, 0x88, 0x88, 0x80, 0x08, 0x88, 0x88,
+  0x88, 0x88, 0x88, 0x89, 0x98, 0x89, 0x8a, 0xa9, 0xd9, 0xca, 0x0c, 0x71, 0x35, 0xa2, 0xcc, 0xce,
+  0xdd, 0x89, 0x75, 0x13, 0x98, 0x99, 0x89, 0x89, 0x00, 0x10, 0x80, 0x80, 0x88, 0x88, 0x08, 0x88,
+  0x88, 0x88, 0x88, 0x98, 0x88, 0x99, 0x98, 0x99, 0x8a, 0xca, 0xd8, 0xbb, 0x0d, 0x71, 0x27, 0x91,
+  0xbc, 0xce, 0xdd, 0x09, 0x75, 0x03, 0x90, 0x9a, 0x98, 0x88, 0x00, 0x10, 0x80, 0x80, 0x88, 0x88,
+  0x08, 0x88, 0x88, 0x88, 0x88, 0x98, 0x90, 0x89, 0x89, 0x9a, 0xb8, 0x99, 0x8c, 0xeb, 0xe9, 0x09,
+  0x71, 0x25, 0xa2, 0xbd, 0xde, 0xcc, 0x1a, 0x77, 0x02, 0x98, 0x99, 0x88, 0x88, 0x00, 0x00, 0x80,
+  0x80, 0x88, 0x08, 0x88, 0x08, 0x88, 0x88, 0x08, 0x89, 0x88, 0x98, 0x88, 0x8a, 0x99, 0xb8, 0x89,
+  0x9c, 0xea, 0xd9, 0x0a, 0x72, 0x27, 0xa1, 0xdb, 0xcd, 0xbe, 0x09, 0x77, 0x02, 0x88, 0x99, 0x89,
+  0x88, 0x00, 0x10, 0x08, 0x88, 0x80, 0x88, 0x08, 0x88, 0x90, 0x80, 0x88, 0x88, 0x89, 0x98, 0x88,
+  0x0a, 0x9a, 0xb8, 0x99, 0x8b, 0x9d, 0xea, 0xca, 0x0b, 0x72, 0x47, 0x91, 0xbc, 0xdd, 0xcd, 0x09,
+  0x76, 0x12, 0x98, 0x99, 0x98, 0x88, 0x00, 0x00, 0x00, 0x88, 0x08, 0x88, 0x08, 0x88, 0x08, 0x09,
+  0x88, 0x98, 0x88, 0x98, 0x98, 0x89, 0x99, 0xa9, 0xb9, 0x99, 0x8d, 0xba, 0xfa, 0xda, 0x0a, 0x73,
+  0x27, 0xa1, 0xeb, 0xdc, 0xcd, 0x18, 0x57, 0x02, 0x98, 0x99, 0x98, 0x88, 0x00, 0x01, 0x00, 0x88,
+  0x88, 0x08, 0x88, 0x88, 0x80, 0x88, 0x88, 0x89, 0x88, 0x98, 0x89, 0x8a, 0xa9, 0xb8, 0x99, 0x8c,
+  0xbb, 0xe8, 0xa9, 0x9e, 0x9d, 0x30, 0x77, 0x02, 0xba, 0xdd, 0xdd, 0x8b, 0x71, 0x27, 0x80, 0x99,
+  0x89, 0x88, 0x08, 0x00, 0x81, 0x80, 0x88, 0x08, 0x88, 0x80, 0x88, 0x08, 0x88, 0x88, 0x09, 0x89,
+  0x98, 0x98, 0x98, 0x8a, 0x9a, 0xb9, 0xa9, 0x8c, 0x9c, 0xfa, 0xca, 0x1b, 0x72, 0x37, 0xa2, 0xbd,
+  0xce, 0xbe, 0x09, 0x77, 0x02, 0x88, 0x8a, 0x98, 0x88, 0x00, 0x10, 0x08, 0x88, 0x80, 0x88, 0x80,
+  0x88, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x89, 0x99, 0xa8, 0xa8, 0x8a, 0x9b, 0xbb, 0xe8, 0xa9,
+  0x9f, 0xac, 0x31, 0x77, 0x12, 0xbb, 0xde, 0xdc, 0x9b, 0x72, 0x37, 0x88, 0x99, 0x98, 0x88, 0x08,
+  0x10, 0x00, 0x88, 0x08, 0x88, 0x88, 0x80, 0x88, 0x08, 0x88, 0x98, 0x90, 0x88, 0x89, 0x99, 0x89,
+  0xa9, 0xb8, 0x99, 0x8c, 0xbb, 0xf9, 0xba, 0x8f, 0x58, 0x36, 0x03, 0xcc, 0xdd, 0xec, 0x8a, 0x72,
+  0x17, 0x80, 0x99, 0x98, 0x88, 0x00, 0x00, 0x80, 0x80, 0x88, 0x80, 0x08, 0x88, 0x08, 0x88, 0x88,
+  0x90, 0x08, 0x89, 0x88, 0x98, 0x89, 0x8a, 0xa9, 0xb8, 0xa8, 0x8c, 0xae, 0xeb, 0x18, 0x75, 0x23,
+  0xc8, 0xdc, 0xdc, 0xad, 0x48, 0x57, 0x81, 0x98, 0x89, 0x89, 0x08, 0x00, 0x00, 0x80, 0x08, 0x88,
+  0x88, 0x80, 0x08, 0x88, 0x88, 0x88, 0x88, 0x88, 0x89, 0x98, 0x89, 0x9a, 0xa9, 0xb8, 0x99, 0x9d,
+  0xcc, 0xea, 0x18, 0x75, 0x23, 0xc8, 0xdc, 0xdc, 0xad, 0x48, 0x57, 0x81, 0x98, 0x89, 0x89, 0x08,
+  0x00, 0x00, 0x80, 0x08, 0x88, 0x88, 0x80, 0x88, 0x80, 0x88, 0x88, 0x88, 0x89, 0x98, 0x98, 0x98,
+  0x99, 0x9a, 0xc8, 0xa8, 0xaa, 0xaf, 0xcb, 0x30, 0x77, 0x13, 0xca, 0xdc, 0xdd, 0x9b, 0x71, 0x27,
+  0x00, 0xa9, 0x98, 0x88, 0x08, 0x00, 0x81, 0x80, 0x88, 0x80, 0x88, 0x80, 0x88, 0x08, 0x89, 0x90,
+  0x88, 0x88, 0x89, 0x99, 0xa8, 0x99, 0x9a, 0xaa, 0xd9, 0xb9, 0x9f, 0x9d, 0x31, 0x77, 0x01, 0xba,
+  0xdd, 0xec, 0x9a, 0x72, 0x17, 0x80, 0x99, 0x88, 0x88, 0x08, 0x00, 0x00, 0x08, 0x88, 0x88, 0x80,
+  0x08, 0x88, 0x88, 0x08, 0x98, 0x80, 0x89, 0x98, 0x98, 0x98, 0x99, 0x9a, 0xb9, 0xb8, 0xab, 0xbf,
+  0xcd, 0x00, 0x67, 0x22, 0xb9, 0xed, 0xcc, 0x9e, 0x58, 0x27, 0x01, 0x99, 0x99, 0x98, 0x08, 0x00,
+  0x01, 0x08, 0x88, 0x88, 0x88, 0x80, 0x08, 0x09, 0x88, 0x98, 0x88, 0x88, 0x99, 0xa8, 0x98, 0x8a,
+  0x9b, 0xba, 0xc9, 0x9a, 0x8e, 0xcc, 0xda, 0x19, 0x75, 0x24, 0xb8, 0xdc, 0xdd, 0xad, 0x38, 0x77,
+  0x01, 0x98, 0x89, 0x89, 0x08, 0x00, 0x00, 0x08, 0x88, 0x80, 0x88, 0x80, 0x88, 0x80, 0x88, 0x08,
+  0x89, 0x88, 0x88, 0x89, 0x99, 0xa8, 0xa8, 0x8a, 0xbb, 0xd8, 0x99, 0x8c, 0xcc, 0xea, 0x8a, 0x71,
+  0x27, 0x92, 0xdb, 0xcd, 0xce, 0x89, 0x75, 0x04, 0x88, 0x99, 0x88, 0x09, 0x08, 0x00, 0x81, 0x08,
+  0x88, 0x88, 0x80, 0x08, 0x88, 0x88, 0x80, 0x09, 0x89, 0x88, 0x98, 0x89, 0x99, 0xa8, 0x8a, 0x9c,
+  0xc8, 0xa8, 0x8b, 0xcb, 0xd0, 0xab, 0xaf, 0x9a, 0x66, 0x34, 0xa1, 0xfc, 0xdb, 0xbe, 0x1a, 0x77,
+  0x02, 0x88, 0x99, 0x98, 0x88, 0x00, 0x01, 0x80, 0x08, 0x88, 0x88, 0x80, 0x88, 0x80, 0x88, 0x88,
+  0x88, 0x88, 0x88, 0x99, 0x98, 0x89, 0x9b, 0xb8, 0x9a, 0x8d, 0xba, 0xa9, 0x8e, 0xb9, 0xb8, 0x9d,
+  0xcd, 0xca, 0x59, 0x65, 0x04, 0xa9, 0xbe, 0xde, 0x9c, 0x60, 0x27, 0x81, 0x99, 0x89, 0x89, 0x08,
+  0x00, 0x00, 0x80, 0x08, 0x88, 0x08, 0x88, 0x08, 0x88, 0x88, 0x88, 0x88, 0x88, 0x89, 0xa8, 0x88,
+  0x9a, 0xb9, 0x99, 0x9c, 0xc9, 0x99, 0x9c, 0xd9, 0x89, 0xab, 0xd8, 0x99, 0xaf, 0xea, 0x18, 0x65,
+  0x15, 0xa8, 0xbd, 0xfd, 0xbb, 0x59, 0x57, 0x01, 0x98, 0x8a, 0x98, 0x80, 0x00, 0x00, 0x00, 0x88,
+  0x88, 0x80, 0x88, 0x80, 0x08, 0x88, 0x88, 0x09, 0x98, 0x88, 0x89, 0x99, 0x98, 0x9a, 0xb9, 0xa9,
+  0x9c, 0xd9, 0x99, 0x9c, 0xc8, 0x8a, 0x9c, 0xc8, 0x8a, 0xbd, 0xfb, 0x0b, 0x72, 0x37, 0x81, 0xdc,
+  0xeb, 0xbe, 0x0a, 0x77, 0x12, 0x98, 0x99, 0x98, 0x88, 0x00, 0x10, 0x80, 0x90, 0x80, 0x88, 0x80,
+  0x08, 0x88, 0x90, 0x08, 0x98, 0x80, 0x89, 0x98, 0x98, 0x89, 0xa9, 0x99, 0xab, 0xd8, 0x8a, 0xbb,
+  0xd8, 0x8b, 0xcb, 0xb8, 0x0d, 0xca, 0xa8, 0x9f, 0xeb, 0x19, 0x74, 0x25, 0x98, 0xcd, 0xfb, 0xad,
+  0x39, 0x77, 0x01, 0x98, 0x89, 0x88, 0x09, 0x00, 0x00, 0x80, 0x08, 0x88, 0x08, 0x88, 0x80, 0x08,
+  0x88, 0x88, 0x88, 0x88, 0x88, 0x89, 0x98, 0x09, 0xaa, 0xb0, 0x8a, 0xbb, 0xc9, 0x9b, 0xeb, 0xa8,
+  0x8c, 0xca, 0x98, 0x8c, 0xfa, 0xaa, 0x9e, 0x42, 0x67, 0x81, 0xca, 0xcc, 0xce, 0x9a, 0x75, 0x14,
+  0x90, 0x99, 0x98, 0x88, 0x08, 0x01, 0x00, 0x88, 0x08, 0x88, 0x08, 0x88, 0x08, 0x88, 0x88, 0x88,
+  0x88, 0x88, 0x99, 0x98, 0x89, 0xa9, 0xa8, 0x8b, 0xac, 0xc8, 0x8b, 0xcb, 0xb8, 0x8c, 0xcb, 0xb8,
+  0x8c, 0xdd, 0xca, 0x1c, 0x74, 0x25, 0x90, 0xcd, 0xdc, 0xae, 0x29, 0x77, 0x01, 0x98, 0x89, 0x88,
+  0x88, 0x00, 0x00, 0x80, 0x80, 0x88, 0x08, 0x88, 0x80, 0x08, 0x88, 0x88, 0x08, 0x89, 0x90, 0x88,
+  0x89, 0x99, 0x89, 0x8b, 0xb9, 0xa9, 0x8d, 0xba, 0xa9, 0x8d, 0xca, 0xa8, 0x9c, 0xec, 0xba, 0x4b,
+  0x76, 0x14, 0xa8, 0xcd, 0xec, 0xbc, 0x58, 0x47, 0x01, 0x99, 0x89, 0x89, 0x88, 0x10, 0x00, 0x80,
+  0x88, 0x08, 0x88, 0x80, 0x88, 0x80, 0x88, 0x88, 0x88, 0x88, 0x89, 0x99, 0x88, 0x9a, 0xa9, 0x99,
+  0x8c, 0xca, 0xa8, 0x8c, 0xca, 0xb0, 0x0b, 0xad, 0xf9, 0xab, 0x9c, 0x56, 0x45, 0x90, 0xeb, 0xeb,
+  0xbe, 0x09, 0x77, 0x02, 0x98, 0x89, 0x98, 0x88, 0x00, 0x00, 0x00, 0x08, 0x88, 0x88, 0x80, 0x88,
+  0x80, 0x08, 0x98, 0x80, 0x09, 0x89, 0x98, 0x88, 0x99, 0xa8, 0x8a, 0x9b, 0xc9, 0x8a, 0x9d, 0xc8,
+  0x98, 0x8c, 0xc9, 0xa9, 0xaf, 0xbb, 0x73, 0x47, 0x01, 0xda, 0xcc, 0xce, 0x8b, 0x73, 0x27, 0x80,
+  0x99, 0x89, 0x88, 0x08, 0x00, 0x00, 0x08, 0x88, 0x08, 0x88, 0x08, 0x88, 0x88, 0x80, 0x88, 0x88,
+  0x98, 0x88, 0x99, 0xa0, 0x89, 0xaa, 0xb8, 0x8a, 0x9d, 0xb9, 0x9a, 0x9d, 0xc9, 0x89, 0xac, 0xf9,
+  0xba, 0x9d, 0x54, 0x37, 0x81, 0xfb, 0xdb, 0xbe, 0x8b, 0x77, 0x13, 0x98, 0x99, 0x89, 0x09, 0x08,
+  0x10, 0x00, 0x88, 0x88, 0x08, 0x88, 0x80, 0x88, 0x90, 0x80, 0x09, 0x98, 0x88, 0x89, 0xa8, 0x89,
+  0x9a, 0xb8, 0x8a, 0xac, 0xb8, 0x8c, 0xcb, 0xb8, 0x8c, 0xcb, 0x98, 0x8d, 0xea, 0xba, 0x9e, 0x31,
+  0x77, 0x03, 0xd9, 0xbc, 0xdf, 0xaa, 0x72, 0x27, 0x90, 0x98, 0x89, 0x88, 0x08, 0x00, 0x00, 0x80,
+  0x88, 0x80, 0x08, 0x88, 0x80, 0x88, 0x90, 0x80, 0x88, 0x98, 0x08, 0x99, 0x90, 0x0a, 0xb9, 0x98,
+  0x8b, 0xc9, 0x8a, 0xac, 0xb8, 0x8c, 0xda, 0x98, 0x9c, 0xb8, 0x0b, 0xdc, 0xc9, 0xae, 0x88, 0x77,
+  0x13, 0xc1, 0xbc, 0xee, 0xcb, 0x49, 0x57, 0x01, 0x98, 0x99, 0x88, 0x88, 0x00, 0x00, 0x80, 0x80,
+  0x88, 0x80, 0x08, 0x88, 0x80, 0x88, 0x88, 0x08, 0x89, 0x88, 0x98, 0xa0, 0x88, 0xa9, 0x98, 0x9b,
+  0xb9, 0x9b, 0xea, 0x89, 0xac, 0xa8, 0x8d, 0xb9, 0x8a, 0xbc, 0xa8, 0x9d, 0xc0, 0x0c, 0xfb, 0xaa,
+  0x8c, 0x57, 0x34, 0xb1, 0xbd, 0xdf, 0xbc, 0x2a, 0x77, 0x03, 0x98, 0x99, 0x88, 0x89, 0x00, 0x01,
+  0x00, 0x88, 0x88, 0x08, 0x88, 0x80, 0x88, 0x80, 0x88, 0x88, 0x88, 0x88, 0x09, 0x99, 0x88, 0x9a,
+  0x98, 0x9b, 0xb8, 0x9b, 0xda, 0x8a, 0xcb, 0x99, 0xbc, 0xb0, 0x9d, 0xc8, 0x0b, 0xe9, 0x09, 0xca,
+  0x08, 0xbb, 0x90, 0xbf, 0xea, 0x0c, 0x55, 0x35, 0xa2, 0xbd, 0xde, 0xbd, 0x1b, 0x77, 0x03, 0x88,
+  0x8a, 0x89, 0x88, 0x08, 0x01, 0x00, 0x88, 0x88, 0x08, 0x08, 0x88, 0x08, 0x88, 0x88, 0x88, 0x90,
+  0x88, 0x88, 0x89, 0xa8, 0x88, 0xa9, 0x89, 0xba, 0x98, 0xad, 0xa0, 0x9c, 0xb8, 0x9c, 0xb8, 0x8c,
+  0xd9, 0x8a, 0xc9, 0x0a, 0xda, 0x09, 0xcb, 0x80, 0xac, 0x90, 0xae, 0xd9, 0x9e, 0x41, 0x47, 0x04,
+  0xba, 0xfc, 0xcc, 0xbb, 0x73, 0x37, 0x91, 0x99, 0x89, 0x88, 0x88, 0x01, 0x00, 0x80, 0x88, 0x08,
+  0x88, 0x80, 0x88, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x98, 0x09, 0xa9, 0x88, 0xba, 0x88, 0xac,
+  0xa0, 0xbb, 0xb8, 0xad, 0xb8, 0x9c, 0xb9, 0x9d, 0xc8, 0x0b, 0xca, 0x8a, 0xea, 0x09, 0xca, 0x08,
+  0xcb, 0x00, 0xbd, 0xd9, 0xae, 0x31, 0x77, 0x13, 0xba, 0xec, 0xdd, 0xbb, 0x71, 0x37, 0x80, 0x99,
+  0x98, 0x88, 0x88, 0x10, 0x00, 0x80, 0x88, 0x08, 0x88, 0x80, 0x88, 0x80, 0x88, 0x80, 0x88, 0x98,
+  0x08, 0x89, 0x88, 0xa9, 0x90, 0x9a, 0x98, 0xab, 0xb8, 0x9c, 0xb9, 0x8d, 0xc9, 0x8a, 0xd9, 0x09,
+  0xca, 0x09, 0xac, 0x98, 0xac, 0x90, 0x9d, 0xa0, 0x0c, 0xd8, 0xab, 0xfc, 0x29, 0x65, 0x35, 0xb8,
+  0xcc, 0xce, 0xcc, 0x49, 0x47, 0x02, 0x99, 0x99, 0x98, 0x08, 0x18, 0x00, 0x00, 0x88, 0x88, 0x08,
+  0x08, 0x88, 0x90, 0x80, 0x88, 0x08, 0x89, 0x88, 0x98, 0x90, 0x99, 0xa0, 0x8a, 0xb8, 0x8a, 0xca,
+  0x89, 0xcb, 0x98, 0xac, 0xa0, 0x8d, 0xb9, 0x8a, 0xda, 0x09, 0xcb, 0x88, 0xac, 0xa1, 0x9c, 0xe1,
+  0xbb, 0xec, 0x58, 0x55, 0x23, 0xd9, 0xdb, 0xce, 0xac, 0x70, 0x26, 0x81, 0x99, 0x89, 0x98, 0x08,
+  0x00, 0x10, 0x88, 0x08, 0x88, 0x08, 0x88, 0x80, 0x88, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x89,
+  0x98, 0x89, 0xa0, 0x09, 0x99, 0x09, 0xaa, 0x09, 0x9b, 0x90, 0x99, 0x90, 0x19, 0x90, 0x11, 0x10,
+  0x11, 0x11, 0x12, 0x31, 0x01,
+};
+
+const adpcmClip adpcmClipTable[] PROGMEM =
+{
+  { 3529, clipGrumble },
+};
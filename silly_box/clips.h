@@ -0,0 +1,35 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// IMA-ADPCM voice clips for SEQ_PLAY_SAMPLE (see tonesynth.h)
+//
+// Generated by tools/adpcm_encode.py from grumble.wav.  Don't edit, run it again.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "tonesynth.h"
+
+enum clipId
+{
+  CLIP_GRUMBLE,
+  NUM_CLIPS
+};
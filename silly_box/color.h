@@ -28,6 +28,9 @@
 
 #define RGB(R, G, B) (((uint32_t) R<<16)+((uint32_t) G<<8)+B)
 
+// Intensity (0 - 255) to LED drive value, gamma corrected (see color.cpp)
+extern const uint8_t gammaTable[256] PROGMEM;
+
 const uint32_t clAqua = RGB(0, 255, 255);
 const uint32_t clBlack = RGB(0, 0, 0);
 const uint32_t clBlue = RGB(0, 0, 255);
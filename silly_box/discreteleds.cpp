@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the discreteLeds class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! LED implementation for UNO and Nano                                                    !!
+// !!                                                                                        !!
+// !! In order to perform true RGB, each component (color) intensity value is between 0      !!
+// !! and 255.  There are not enough PWM output pins on the UNO/Nano to support both the     !!
+// !! servos and LEDs so the LEDs are on the analog pins A0 thru A5, used as digital         !!
+// !! outputs, and the PWM is generated in software by the ledPwm class.  setPixel() only    !!
+// !! hands the intensities to ledPwm which shows them from the next 1ms frame.             !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#include "discreteleds.h"
+#include "ledpwm.h"
+#include "color.h"
+
+const int discreteLeds::ledPins[numPixels][3] = {{A0, A1, A2}, {A3, A4, A5}};
+uint32_t discreteLeds::s_color[numPixels];
+
+void discreteLeds::setup()
+{
+  // Channel numbers are the index into ledPins, i.e. LED * 3 + component
+  static_assert(sizeof(ledPins)/sizeof(ledPins[0][0]) == ledPwm::numChannels, "ledPins does not match ledPwm::numChannels");
+  ledPwm::setup(&ledPins[0][0]);
+}
+
+//
+// setPixel
+//
+// Hands the components of a color that have changed to the PWM, through the gamma table
+//
+
+void discreteLeds::setPixel(uint8_t pixel, uint32_t color)
+{
+  uint32_t changed = s_color[pixel] ^ color;
+
+  s_color[pixel] = color;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    uint8_t shift = 16 - 8*i;   // red, green then blue
+    if ((changed >> shift) & 0xff)
+    {
+      ledPwm::write(pixel*3 + i, pgm_read_byte_near(&gammaTable[(color >> shift) & 0xff]));
+    }
+  }
+}
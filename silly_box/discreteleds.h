@@ -0,0 +1,53 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// discreteLeds class drives the two RGB LEDs, one on each side of the box.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// LED hardware for ledSequence (see ledsequence.h).  Each component of each LED is a ledPwm
+// channel.  There is nothing to flush since ledPwm picks up changes at the start of its 
+// next frame.
+//
+
+class discreteLeds
+{
+  public:
+    static const uint8_t numPixels = 2;
+
+  private:
+    static const int ledPins[numPixels][3];
+
+  // Methods
+  public:
+    static void setup();
+    static uint32_t getPixel(uint8_t pixel) { return s_color[pixel]; }
+    static void setPixel(uint8_t pixel, uint32_t color);
+    static bool flush() { return true; }
+
+  // Attributes
+  private:
+    static uint32_t s_color[numPixels];
+};
@@ -23,22 +23,32 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
 
-//#define DEBUG
+//#define TRACE
 
 #include "group.h"
+#include "profiler.h"
 
+#ifdef TRACE
 //
-// group class implementation
+// Timing report for a group whose primary sequence has just finished.  'late' is how far 
+// behind its schedule the primary sequence finished, which is the timing drift accumulated 
+// over the whole group.
 //
 
-group::group(sequence* const* sequenceTbl)
+static uint32_t groupStartMs;
+
+static void reportTiming(sequence* pPrimary)
 {
-  m_pSequenceTbl = sequenceTbl;
-  m_groupState = GROUP_EXECUTING;
+  uint32_t now = millis();
+  Trace(TR_GROUP_TIME, now - groupStartMs, static_cast<int16_t> (now - pPrimary->getNextDeadline()));
 }
+#endif
+
+//
+// group class implementation
+//
 
 group::~group()
 {
@@ -63,6 +73,54 @@ bool group::getSwitchOffAttempted()
        return pSequence->getSwitchOffAttempted();
     }
   }
+  return false;
+}
+
+//
+// getPrimaryDeadline
+//
+// The primary sequence's deadline.  Once the group is complete this is when the primary 
+// sequence was scheduled to finish, so millis() less this is how late the group finished.
+//
+
+uint32_t group::getPrimaryDeadline()
+{
+  sequence* pSequence;
+
+  // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
+  for (int i = 0; 
+       (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
+       i++)
+  {
+    if (pSequence->getSeqType() == sequence::PRIMARY_SEQ)
+    {
+       return pSequence->getNextDeadline();
+    }
+  }
+  return millis();
+}
+
+//
+// getNestingDepth
+//
+// The deepest any of the group's sequence tables takes its flow control stack (see 
+// sequence::getNestingDepth())
+//
+
+uint8_t group::getNestingDepth()
+{
+  sequence* pSequence;
+  uint8_t deepest = 0;
+
+  // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
+  for (int i = 0; 
+       (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
+       i++)
+  {
+    uint8_t depth = pSequence->getNestingDepth();
+    if (depth > deepest) deepest = depth;
+  }
+  return deepest;
 }
 
 void group::reset()
@@ -82,20 +140,50 @@ void group::reset()
 void group::start()
 {
   sequence* pSequence;
+  uint32_t startMs = millis(); // all of the sequences are timed from the same moment
+#ifdef TRACE
+  groupStartMs = startMs;
+#endif
 
   // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
   for (int i = 0; 
        (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
        i++)
   {
-    pSequence->startSequence();
+    pSequence->setVmSlot(i);
+    pSequence->startSequence(startMs);
+#ifdef GROUP_DEADLINE_DISPATCH
+    s_readyList[i].pSequence = pSequence;
+    s_readyList[i].deadline = pSequence->getNextDeadline();
+    s_readyList[i].index = i;
+    s_numReady = i + 1;
+#endif
   }
+#ifdef GROUP_DEADLINE_DISPATCH
+  sortReadyList(millis());
+#endif
   m_groupState = GROUP_EXECUTING;
 }
 
+void group::stopAll()
+{
+  sequence* pSequence;
+
+  // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
+  for (int i = 0; 
+       (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
+       i++)
+  {
+    pSequence->stopSequence();
+  }
+}
+
+#ifndef GROUP_DEADLINE_DISPATCH
+
 group::groupState group::loop() 
 {
   if (m_groupState == GROUP_COMPLETE || m_groupState == GROUP_NOT_EXECUTING) return GROUP_COMPLETE;
+  ProfileSection(PROF_GROUP_LOOP);
 
   sequence* pSequence;
 
@@ -108,6 +196,9 @@ group::groupState group::loop()
     if (pSequence->getSeqType() == sequence::PRIMARY_SEQ 
     &&  pSequence->getSeqState() == sequence::SEQ_COMPLETE)
     {
+#ifdef TRACE
+       reportTiming(pSequence);
+#endif
        m_groupState = GROUP_COMPLETE;
        break;
     }
@@ -116,13 +207,142 @@ group::groupState group::loop()
   if (m_groupState == GROUP_COMPLETE)
   {
     // stop all sequences
-   // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
-    for (int i = 0; 
-         (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
-         i++)
+    stopAll();
+  }
+  return m_groupState;
+}
+
+//
+// getNextDeadline
+//
+// Returns the earliest millis() value at which one of the executing sequences has something
+// to do.
+//
+
+uint32_t group::getNextDeadline()
+{
+  uint32_t now = millis();
+  uint32_t earliest = now + 0x7FFFFFFF;
+  sequence* pSequence;
+
+  // Iterate through the table in PROGMEM using 'pgm_read_ptr_near'
+  for (int i = 0; 
+       (pSequence = static_cast<sequence *> (pgm_read_ptr_near(&m_pSequenceTbl[i]))) != NULL; 
+       i++)
+  {
+    if (pSequence->getSeqState() != sequence::SEQ_EXECUTING) continue;
+    uint32_t deadline = pSequence->getNextDeadline();
+    if (static_cast<int32_t> (deadline - earliest) < 0) earliest = deadline;
+  }
+  return earliest;
+}
+
+#else // GROUP_DEADLINE_DISPATCH
+
+group::readyEntry group::s_readyList[sequence::maxGroupSequences];
+uint8_t group::s_numReady;
+
+//
+// loop
+//
+// The ready list is ordered by deadline so the sequences that are due are at the front.  Each
+// due sequence is processed once, its deadline is refreshed, and the list is re-sorted.
+// Sequences that are no longer executing (a finished ONE_SHOT) drop off the list.
+//
+
+group::groupState group::loop() 
+{
+  if (m_groupState == GROUP_COMPLETE || m_groupState == GROUP_NOT_EXECUTING) return GROUP_COMPLETE;
+  ProfileSection(PROF_GROUP_LOOP);
+
+  uint32_t now = millis();
+  uint8_t numDue = 0;
+
+  while (numDue < s_numReady 
+  &&     static_cast<int32_t> (s_readyList[numDue].deadline - now) <= 0)
+  {
+    numDue++;
+  }
+
+  if (numDue == 0) return m_groupState;
+
+  for (uint8_t i = 0; i < numDue; i++)
+  {
+    sequence* pSequence = s_readyList[i].pSequence;
+    pSequence->processSequence();
+    if (pSequence->getSeqType() == sequence::PRIMARY_SEQ 
+    &&  pSequence->getSeqState() == sequence::SEQ_COMPLETE)
     {
-      pSequence->stopSequence();
+#ifdef TRACE
+       reportTiming(pSequence);
+#endif
+       m_groupState = GROUP_COMPLETE;
+       break;
     }
   }
+  
+  if (m_groupState == GROUP_COMPLETE)
+  {
+    // stop all sequences
+    stopAll();
+    s_numReady = 0;
+    return m_groupState;
+  }
+
+  // Refresh the deadlines of the sequences just processed and drop the ones that finished
+  uint8_t numKept = 0;
+  for (uint8_t i = 0; i < s_numReady; i++)
+  {
+    if (i < numDue)
+    {
+      if (s_readyList[i].pSequence->getSeqState() != sequence::SEQ_EXECUTING) continue;
+      s_readyList[i].deadline = s_readyList[i].pSequence->getNextDeadline();
+    }
+    s_readyList[numKept++] = s_readyList[i];
+  }
+  s_numReady = numKept;
+  sortReadyList(now);
+
   return m_groupState;
 }
+
+//
+// getNextDeadline
+//
+// Returns the earliest millis() value at which one of the executing sequences has something
+// to do.
+//
+
+uint32_t group::getNextDeadline()
+{
+  if (s_numReady == 0) return millis() + 0x7FFFFFFF;
+  return s_readyList[0].deadline;
+}
+
+//
+// sortReadyList
+//
+// Insertion sort by deadline (relative to 'now' so millis() rollover is handled), then by 
+// position in the group table so simultaneous sequences run in table order.  There are 
+// never more than a handful of entries.
+//
+
+void group::sortReadyList(uint32_t now)
+{
+  for (uint8_t i = 1; i < s_numReady; i++)
+  {
+    readyEntry entry = s_readyList[i];
+    int32_t due = static_cast<int32_t> (entry.deadline - now);
+    uint8_t j = i;
+    while (j > 0)
+    {
+      int32_t prevDue = static_cast<int32_t> (s_readyList[j - 1].deadline - now);
+      if (prevDue < due || (prevDue == due && s_readyList[j - 1].index < entry.index)) break;
+      s_readyList[j] = s_readyList[j - 1];
+      j--;
+    }
+    s_readyList[j] = entry;
+  }
+}
+
+#endif // GROUP_DEADLINE_DISPATCH
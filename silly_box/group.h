@@ -26,6 +26,12 @@
 #pragma once
 #include "sequence.h"
 
+// Define GROUP_DEADLINE_DISPATCH to have the executing group keep its sequences ordered by 
+// their next deadline and only process the ones that are due.  Otherwise every sequence is
+// processed on every call to loop().
+
+#define GROUP_DEADLINE_DISPATCH
+
 class group
 {
   public:
@@ -38,16 +44,46 @@ class group
   
   // Methods
   public:
-    group(sequence* const* sequenceTbl);    
+    // Takes the NULL terminated table itself (not a pointer to it) so its size can be 
+    // checked: the executing group's sequences share sequence::maxGroupSequences flow 
+    // control stacks and ready list entries.
+    template <size_t N> group(sequence* const (&sequenceTbl)[N])
+    {
+      m_pSequenceTbl = sequenceTbl;
+      m_groupState = GROUP_EXECUTING;
+      static_assert(N - 1 <= sequence::maxGroupSequences, "too many sequences in a group (see sequence::maxGroupSequences)");
+    }
     ~group();    
     void reset();
     void start();
     groupState getState(); 
     bool getSwitchOffAttempted();
+    uint32_t getPrimaryDeadline();
+    uint8_t getNestingDepth();
+    uint32_t getNextDeadline();
     groupState loop(); 
 
+  private:
+    void stopAll();
+#ifdef GROUP_DEADLINE_DISPATCH
+    static void sortReadyList(uint32_t);
+#endif
+
   // Attributes
   private:
     sequence* const* m_pSequenceTbl;
     groupState m_groupState;
+
+#ifdef GROUP_DEADLINE_DISPATCH
+    // Ready list for the executing group, ordered by deadline.  Only one group executes
+    // at a time so this is shared by all groups.
+    struct readyEntry
+    {
+      sequence* pSequence;
+      uint32_t deadline;
+      uint8_t index;  // position in the group table (breaks ties)
+    };
+    static readyEntry s_readyList[sequence::maxGroupSequences];
+    static uint8_t s_numReady;
+#endif
 };
@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the ledPwm class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! Timer0 is shared with millis()                                                         !!
+// !!                                                                                        !!
+// !! The Arduino core runs Timer0 in fast PWM mode for analogWrite() on pins 5 and 6.  In   !!
+// !! the PWM modes a new OCR0A value only takes effect at the end of the cycle so the       !!
+// !! slots couldn't be chained within a frame.  setup() switches Timer0 to normal mode.     !!
+// !! It still overflows every 256 counts so millis() and micros() are unaffected, but      !!
+// !! analogWrite() no longer works on pins 5 and 6.  Those are the servo pins which are     !!
+// !! driven by the Servo library from Timer1, so nothing is lost.                           !!
+// !!                                                                                        !!
+// !! Cost: 7 interrupts per 1.024ms frame of roughly 90 cycles each (more at the start of   !!
+// !! a frame after a write()), about 4% of the processor.  Define PROFILE (see profiler.h)  !!
+// !! to measure it; the time in the interrupt is read from Timer1 (0.5us per count) and     !!
+// !! reported by getCpuPermille().                                                          !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#include "ledpwm.h"
+#include "profiler.h"
+
+volatile uint8_t* ledPwm::s_pPort;
+uint8_t ledPwm::s_portMask = 0;
+uint8_t ledPwm::s_channelMask[numChannels];
+uint8_t ledPwm::s_planes[numPlanes];
+uint8_t ledPwm::s_shadowPlanes[numPlanes];
+volatile bool ledPwm::s_shadowChanged = false;
+uint8_t ledPwm::s_slot = 0;
+uint8_t ledPwm::s_frame = 0;
+
+#ifdef PROFILE
+// Interrupt cost measurement
+static const uint8_t isrEntryExitCounts = 4;  // register save/restore not seen by Timer1 (~32 cycles)
+static volatile uint32_t busyCounts = 0;       // Timer1 counts spent in the interrupt
+static uint32_t windowStartUs = 0;
+#endif
+
+ISR(TIMER0_COMPA_vect)
+{
+  ledPwm::slotChange();
+}
+
+//
+// setup
+//
+// pPins points to numChannels pin numbers, one per channel
+//
+
+void ledPwm::setup(const int* pPins)
+{
+  s_pPort = portOutputRegister(digitalPinToPort(pPins[0]));
+  for (uint8_t i = 0; i < numChannels; i++)
+  {
+    pinMode(pPins[i], OUTPUT);
+    digitalWrite(pPins[i], LOW);
+    s_channelMask[i] = digitalPinToBitMask(pPins[i]);
+    s_portMask |= s_channelMask[i];
+  }
+
+  // Normal mode (see the note at the beginning of this file) and start the first frame
+  // when the count next wraps
+  noInterrupts();
+  TCCR0A &= ~(bit(WGM01) | bit(WGM00));
+  s_slot = 0;
+  OCR0A = 0;
+  TIFR0 = bit(OCF0A);
+  TIMSK0 |= bit(OCIE0A);
+  interrupts();
+
+#ifdef PROFILE
+  windowStartUs = micros();
+#endif
+}
+
+//
+// write
+//
+// Sets the intensity (0 - 255) of a channel starting with the next frame
+//
+
+void ledPwm::write(uint8_t channel, uint8_t value)
+{
+  uint8_t mask = s_channelMask[channel];
+
+  noInterrupts();
+  for (uint8_t i = 0; i < ditherFrames; i++)
+  {
+    // Bits 0 and 1 are on for that many of the 4 frames
+    if ((value & 0x03) > i) s_shadowPlanes[i] |= mask;
+    else s_shadowPlanes[i] &= ~mask;
+  }
+  value >>= 2;
+  for (uint8_t i = ditherFrames; i < numPlanes; i++)
+  {
+    if (value & 0x01) s_shadowPlanes[i] |= mask;
+    else s_shadowPlanes[i] &= ~mask;
+    value >>= 1;
+  }
+  s_shadowChanged = true;
+  interrupts();
+}
+
+//
+// slotChange
+//
+// Called from the Timer0 compare A interrupt at the start of each slot.  Shows the slot and
+// sets the compare up for the start of the next one.
+//
+
+void ledPwm::slotChange()
+{
+#ifdef PROFILE
+  uint16_t startCount = TCNT1;
+#endif
+  uint8_t slot = s_slot;
+  uint8_t nextStart;
+
+  do
+  {
+    uint8_t plane;
+
+    if (slot == 0)
+    {
+      // New frame.  Pick up any writes.
+      if (s_shadowChanged)
+      {
+        memcpy(s_planes, s_shadowPlanes, numPlanes);
+        s_shadowChanged = false;
+      }
+      s_frame = (s_frame + 1) & (ditherFrames - 1);
+      plane = s_planes[s_frame];
+    }
+    else
+    {
+      plane = s_planes[ditherFrames + slot - 1];
+    }
+    *s_pPort = (*s_pPort & ~s_portMask) | plane;
+
+    if (++slot == numSlots) slot = 0;
+    nextStart = (slot == 0) ? 0 : 2 << slot;
+
+    // If other interrupts held this one up past the start of the next slot, show the next
+    // slot now (a slightly short slot) rather than miss the compare and lose a whole frame
+  } while (slot != 0 && TCNT0 >= nextStart);
+
+  OCR0A = nextStart;
+  s_slot = slot;
+
+#ifdef PROFILE
+  // A Servo frame starting part way through resets TCNT1; that one isn't counted
+  uint16_t endCount = TCNT1;
+  if (endCount >= startCount) busyCounts += (endCount - startCount) + isrEntryExitCounts;
+#endif
+}
+
+//
+// getCpuPermille
+//
+// Returns the time spent in the interrupt, in parts per thousand, since the last call and
+// starts a new measurement window.  Only measured when PROFILE is defined, otherwise 0.
+//
+
+uint16_t ledPwm::getCpuPermille()
+{
+#ifdef PROFILE
+  uint32_t nowUs = micros();
+  uint32_t windowUs = nowUs - windowStartUs;
+  uint32_t busyUs;
+
+  noInterrupts();
+  busyUs = busyCounts >> 1;
+  busyCounts = 0;
+  interrupts();
+  windowStartUs = nowUs;
+
+  // Scale both down to keep the multiply from overflowing on long windows
+  return static_cast<uint16_t> (((busyUs >> 8) * 1000) / ((windowUs >> 8) + 1));
+#else
+  return 0;
+#endif
+}
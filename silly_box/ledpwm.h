@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ledPwm class generates the PWM for the RGB LEDs in software since they are not on PWM
+// capable pins.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// Bit angle modulation (BAM) of up to 8 output pins with 8 bit intensities.  Each frame is
+// one 256 count cycle of Timer0 (1.024ms) split into slots whose lengths are the weights of
+// the intensity bits.  At the start of each slot the Timer0 compare A interrupt writes the
+// pins for that slot to the port in one go.  write() only updates a shadow copy which the
+// interrupt picks up at the start of the next frame, so an LED never shows half an update.
+//
+// All of the pins MUST be on the same port (A0 - A5 are all on port C).
+//
+
+class ledPwm
+{
+  public:
+    static const uint8_t numChannels = 6;
+
+  private:
+    // Slot 0 (4 counts) shows bits 0 and 1 spread over 4 frames, slots 1 to 6 show bits 2
+    // to 7.  Slot n (n > 0) starts at count 2 << n so the slots add up to exactly 256.
+    static const uint8_t numSlots = 7;
+    static const uint8_t ditherFrames = 4;
+    static const uint8_t numPlanes = ditherFrames + numSlots - 1;
+
+  // Methods
+  public:
+    static void setup(const int* pPins);
+    static void write(uint8_t channel, uint8_t value);
+    static uint16_t getCpuPermille();
+    static void slotChange();
+
+  // Attributes
+  private:
+    static volatile uint8_t* s_pPort;
+    static uint8_t s_portMask;                     // the port pins that belong to the LEDs
+    static uint8_t s_channelMask[numChannels];
+
+    // Port bits for each slot.  Planes 0 to 3 are slot 0 in frames 0 to 3, then bits 2 to 7.
+    static uint8_t s_planes[numPlanes];            // being shown by the interrupt
+    static uint8_t s_shadowPlanes[numPlanes];      // updated by write()
+    static volatile bool s_shadowChanged;
+    static uint8_t s_slot;
+    static uint8_t s_frame;
+};
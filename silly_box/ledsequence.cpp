@@ -23,35 +23,15 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-// !!                                                                                        !!  
-// !! LED implementation limitations for UNO and Nano                                        !!
-// !!                                                                                        !!  
-// !! In order to perform true RGB, each component (color) intensity value is between 0      !!
-// !! and 255. This is implemented by using the Arduino 'analogWrite()' function             !!
-// !! (which, oddly, has nothing to do with analog output) to set a PWM duty cycle on the    !!
-// !! LED output pin.  Unfortunately there are not enough available PWM output pins on the   !!
-// !! UNO/Nano to support both the servos and LEDs.  However, because the analogWrite()      !!
-// !! function uses digitalWrite() for intentity values 0 and 255 you can use non-PWM        !!
-// !! outputs and only use RGB colors that have 0 and 255 intensities on the UNO and Nano.   !!  
-// !! Therefore, the same code supports all Arduino platforms by constraining the colors     !!
-// !! used.                                                                                  !!
-// !!                                                                                        !!  
-// !! To further confuse matters, the code below uses the analog pins A0 thru A5 as digital  !!
-// !! outputs.                                                                               !!
-// !!                                                                                        !!  
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-
-// Writes an analog value (PWM wave) to a pin.
-
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
-
-//#define DEBUG
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
+
+//#define TRACE
 
 #include "ledsequence.h"
+#include "profiler.h"
 #include "color.h"
-const int ledSequence::ledPins[2][3] = {{A0, A1, A2}, {A3, A4, A5}};
+
+uint8_t ledSequence::s_fadeFrom[numLeds*3];
 
 //
 // Implementation for the ledSequence class
@@ -59,36 +39,40 @@ const int ledSequence::ledPins[2][3] = {{A0, A1, A2}, {A3, A4, A5}};
 
 ledSequence::ledSequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd):sequence(pSeqTable, aSeqType, aSeqEnd)
 {
-  startSequence();
+  startSequence(millis());
 }
 
 void ledSequence::setup()
 {
-  for (int i = 0; i < numLeds; i++)
-  {
-    for (int j = 0; j < 3; j++)
-    {
-      pinMode(ledPins[i][j], OUTPUT);
-    }
-  }
+  ledHardware::setup();
+}
+
+//
+// flush
+//
+// Shows the LED changes made since the last call.  Call every time loop() is executed, after
+// the sequences have been processed.  Returns false if it needs calling again soon.
+//
+
+bool ledSequence::flush()
+{
+  return ledHardware::flush();
 }
 
-void ledSequence::startSequence()
+void ledSequence::startSequence(uint32_t startMs)
 {
-  sequence::startSequence();
+  sequence::startSequence(startMs);
 }
 
 void ledSequence::stopSequence() 
 {
-  for (int i = 0; i < numLeds; i++)
-  {
-    setLed(i, 0);
-  }
+  setLed(ALL_LEDS, 0);
   sequence::stopSequence();
 }
 
 sequence::actionState ledSequence::executeAction()
 {
+  ProfileSection(PROF_LED_EXECUTE);
   switch (m_seqEntry.action)
   {
     case  ACTION_SET_LED:
@@ -108,141 +92,75 @@ sequence::actionState ledSequence::executeAction()
 
 void ledSequence::prepareAction()
 {
-  sequence::prepareAction();
-}
-
-void ledSequence::setLed(int ledNum, const uint32_t color)
-{
-  if (ledNum == ALL_LEDS)
+  ProfileSection(PROF_LED_PREPARE);
+  if (m_seqEntry.action == ACTION_TRANS_LED)
   {
-    // Set each LED to the same color
-    for (int i = 0; i < numLeds; i++)
+    // The fade starts from whatever the LEDs are showing
+    for (uint8_t i = firstLed(m_seqEntry.data1); i <= lastLed(m_seqEntry.data1); i++)
     {
-      // Remember the last color
-      m_lastColor[i] = color;
-      
-      // See the note at the beginning of this file regarding RGB
-      // implementation
-      analogWrite(ledPins[i][0], (color>>16) & 0xff);
-      analogWrite(ledPins[i][1], (color>>8) & 0xff);
-      analogWrite(ledPins[i][2], color & 0xff);
+      uint32_t color = ledHardware::getPixel(i);
+      s_fadeFrom[i*3] = color >> 16;
+      s_fadeFrom[i*3 + 1] = color >> 8;
+      s_fadeFrom[i*3 + 2] = color;
     }
+    m_fadeStartMs = m_deadlineMs;
   }
-  else
+  else sequence::prepareAction();
+}
+
+void ledSequence::setLed(uint16_t leds, const uint32_t color)
+{
+  for (uint8_t i = firstLed(leds); i <= lastLed(leds); i++)
   {
-    // Set an indivudual LED color
-    
-    // Remember the last color
-    m_lastColor[ledNum] = color;
-      
-    // See the note at the beginning of this file regarding RGB
-    // implementation
-    analogWrite(ledPins[ledNum][0], (color>>16) & 0xff);
-    analogWrite(ledPins[ledNum][1], (color>>8) & 0xff);
-    analogWrite(ledPins[ledNum][2], color & 0xff);
+    ledHardware::setPixel(i, color);
   }
 }
 
+//
+// transitionLed
+//
+// Fades from the colors the LED(s) showed when the action started to the end color (data2)
+// over the duration (data3, ms).  Every component of every LED is interpolated from the 
+// same fraction of the duration so they all arrive together, whatever the distance.  Like 
+// the profiled moves the fraction comes from the time since the fade started so a late
+// update doesn't stretch the fade.
+//
+
 sequence::actionState ledSequence::transitionLed()
 {
-  // This action is not really useful for UNO or Nano
-  
-  // This transition implementation is pretty simple.  Moving toward the
-  // destination color is simply a matter of incrementing each color
-  // until the source color equals the destination color.  Some colors
-  // may finish transitioning before others.
-  //
-  // The speed is dictated by the delay between increments.  Keep in mind
-  // there could be up to 255 increment cycles.
-
-  actionState retVal = ACTION_EXECUTING;
-  
-  uint32_t newColor;  
-  uint8_t sR, sG, sB;
-  uint8_t dR, dG, dB;
-  
-  // If there is no delay or the delay has expired transition one color point for each color
-  if (m_seqEntry.data3 == 0 || millis() - m_prevMillis > m_seqEntry.data3)
+  ProfileSection(PROF_LED_TRANSITION);
+  if (!deadlineReached()) return ACTION_EXECUTING;
+
+  uint32_t endMs = m_fadeStartMs + m_seqEntry.data3;
+  uint32_t elapsedMs = millis() - m_fadeStartMs;
+  uint32_t fraction = 0x10000;  // 16 bit fixed point, 0x10000 is the end color
+
+  if (elapsedMs < m_seqEntry.data3) fraction = (elapsedMs << 16)/m_seqEntry.data3;
+
+  for (uint8_t i = firstLed(m_seqEntry.data1); i <= lastLed(m_seqEntry.data1); i++)
   {
-    // Prepare for next delay
-    m_prevMillis = millis();
-    
-    // Mark the action complete.  This will be overwritten if any of the LEDs
-    // are not finished transitioning.
-    retVal = ACTION_COMPLETE;
-    
-    if (m_seqEntry.data1 == ALL_LEDS)
-    {
-      // Transition all of the LEDs
-      for (int i = 0; i < numLeds; i++)
-      {
-        if (m_lastColor[i] != m_seqEntry.data2)
-        {
-          // If this LED has not finished transitioning then perform
-          // an increment and indicate the action is still executing
-          
-          // Extract the individual RGB values for the source 
-          // color (the last color displayed) and the destination
-          // color (contained in data2)
-          sR = (m_lastColor[i]>>16) & 0xff;
-          sG = (m_lastColor[i]>>8) & 0xff;
-          sB = m_lastColor[i] & 0xff;
-          dR = (m_seqEntry.data2>>16) & 0xff;
-          dG = (m_seqEntry.data2>>8) & 0xff;
-          dB = m_seqEntry.data2 & 0xff;
-          
-          // Increment or decrement based on the direction the
-          // color is moving
-          if (sR < dR) sR++;
-          else if (sR > dR) sR--;
-          if (sG < dG) sG++;
-          else if (sG > dG) sG--;
-          if (sB < dB) sB++;
-          else if (sB > dB) sB--;
-          
-          // Set the new color
-          newColor = RGB(sR, sG, sB);
-          setLed(i, newColor);
-          
-          // Indicate this action is still executing
-          retVal = ACTION_EXECUTING;
-        }
-      }
-    }
-    else
+    uint32_t color = 0;
+    const uint8_t* pFrom = &s_fadeFrom[i*3];
+    for (int8_t shift = 16; shift >= 0; shift -= 8)
     {
-      if (m_lastColor[m_seqEntry.data1] != m_seqEntry.data2)
-      {
-        // If the LED has not finished transitioning then perform
-        // an increment and indicate the action is still executing
-          
-        // Extract the individual RGB values for the source 
-        // color (the last color displayed) and the destination
-        // color (contained in data2)
-        sR = (m_lastColor[m_seqEntry.data1]>>16) & 0xff;
-        sG = (m_lastColor[m_seqEntry.data1]>>8) & 0xff;
-        sB = m_lastColor[m_seqEntry.data1] & 0xff;
-        dR = (m_seqEntry.data2>>16) & 0xff;
-        dG = (m_seqEntry.data2>>8) & 0xff;
-        dB = m_seqEntry.data2 & 0xff;
-          
-        // Increment or decrement based on the direction the
-        // color is moving
-        if (sR < dR) sR++;
-        else if (sR > dR) sR--;
-        if (sG < dG) sG++;
-        else if (sG > dG) sG--;
-        if (sB < dR) sR++;
-        else if (sR > dR) sB--;
-          
-        // Set the new color
-        newColor = RGB(sR, sG, sB);
-        setLed(m_seqEntry.data1, newColor);
-          
-        // Indicate this action is still executing
-        retVal = ACTION_EXECUTING;
-      }
+      int16_t from = *pFrom++;
+      int16_t to = (m_seqEntry.data2 >> shift) & 0xff;
+      uint8_t component = from + ((static_cast<int32_t> (to - from)*fraction + 0x8000) >> 16);
+      color |= static_cast<uint32_t> (component) << shift;
     }
+    ledHardware::setPixel(i, color);
   }
-  return retVal;
+
+  if (fraction == 0x10000)
+  {
+    // The next action is timed from the end of the fade
+    m_deadlineMs = endMs;
+    return ACTION_COMPLETE;
+  }
+
+  // Next update, but no later than the end of the fade
+  advanceDeadline(fadeTickMs);
+  if (static_cast<int32_t> (m_deadlineMs - endMs) > 0) m_deadlineMs = endMs;
+
+  return ACTION_EXECUTING;
 }
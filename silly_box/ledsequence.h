@@ -28,6 +28,35 @@
 #include "sequence.h"
 #include "movesequence.h"
 
+// LED hardware.  Define LED_STRIP to drive a WS2812 strip or LED_PCA9685 to drive LEDs from
+// a PCA9685 PWM chip instead of the two RGB LEDs.  Each class provides:
+//
+//   numPixels             number of LEDs
+//   setup()               hardware initialization
+//   getPixel(pixel)       color last set (RGB)
+//   setPixel(pixel, rgb)  change a pixel.  Unchanged pixels cost next to nothing.
+//   flush()               show the changes, once per pass of loop().  Returns false if it
+//                         has to be called again to finish.
+
+//#define LED_STRIP
+//#define LED_PCA9685
+
+#if defined(LED_STRIP)
+#include "ws2812.h"
+typedef ws2812Strip ledHardware;
+#elif defined(LED_PCA9685)
+#include "pca9685leds.h"
+typedef pca9685Leds ledHardware;
+#else
+#include "discreteleds.h"
+typedef discreteLeds ledHardware;
+#endif
+
+// The PCA9685 is on I2C which uses A4 and A5.  The RGB LEDs are wired to those pins.
+#if defined(SERVO_PCA9685) && !defined(LED_STRIP) && !defined(LED_PCA9685)
+#error "SERVO_PCA9685 needs A4 and A5 for I2C.  Move the LEDs to LED_STRIP or LED_PCA9685."
+#endif
+
 //
 // This sequence class handles the lighting patterns of the LEDs
 //
@@ -35,13 +64,18 @@
 class ledSequence: public sequence
 {
   public:
-    static const int LEFT = 0;
-    static const int RIGHT = 1;
-    static const int ALL_LEDS = 0xFFF;
+    // LED operands are a range of pixels (see LED_RANGE in action.h)
+    static const uint16_t LEFT = LED_RANGE(0, 0);
+    static const uint16_t RIGHT = LED_RANGE(1, 1);
+    static const uint16_t ALL_LEDS = LED_RANGE(0, 0xFF);
 
   private:
-    static const int ledPins[2][3];
-    static const int numLeds = sizeof(ledPins)/sizeof(ledPins[0]);
+    static const uint8_t numLeds = ledHardware::numPixels;
+    static const uint8_t fadeTickMs = 10;  // how often a TRANS_LED fade updates the LEDs
+
+    // Colors (R, G, B) the current fade started from.  Only one LED sequence runs at a time
+    // so this is shared rather than carried by every object.
+    static uint8_t s_fadeFrom[numLeds*3];
 
   // Construction/Destruction
   public:
@@ -50,18 +84,20 @@ class ledSequence: public sequence
   // Methods
   public:
     static void setup();
-    void setLed(int, const uint32_t);
+    static bool flush();
+    void setLed(uint16_t leds, const uint32_t color);
     actionState transitionLed();
-    void startSequence();
+    void startSequence(uint32_t startMs);
     void stopSequence();
 
   private:
     void prepareAction();
     actionState executeAction();
+    static uint8_t firstLed(uint16_t leds) { return leds & 0xFF; }
+    static uint8_t lastLed(uint16_t leds) { return ((leds >> 8) < numLeds) ? (leds >> 8) : numLeds - 1; }
 
   // Attributes
   private:  
     // Additional context needed for processing LED actions
-    uint32_t m_lastColor[numLeds];
+    uint32_t m_fadeStartMs;
 };
-
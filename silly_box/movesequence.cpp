@@ -25,97 +25,208 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
 
-#define DEBUG
+#define TRACE
 
 #include "movesequence.h"
+#include "profiler.h"
 
 // Initialize static members of moveSequence
+#ifdef SERVO_PCA9685
+pca9685 moveSequence::s_servoChip(servoChipAddress);
+#else
 Servo moveSequence::armServo;
 Servo moveSequence::lidServo;
+#endif
+moveSequence::profileState moveSequence::s_axes[NUM_AXES];
+uint32_t moveSequence::s_profileEndMs;
+bool moveSequence::s_strikePending = false;
+bool moveSequence::s_homing = false;
+uint32_t moveSequence::s_homingDeadlineMs;
+
+//
+// Motion profile limits.  This table MUST be kept in the same order as the profileType enum 
+// in action.h.  An MG996R manages roughly 350-400 deg/s unloaded.
+//
+
+const moveSequence::motionProfile moveSequence::motionProfiles[] PROGMEM =
+{
+  // Shape            Velocity  Accel
+  { SHAPE_TRAPEZOID,  400,      5000 },   // PROFILE_STRIKE
+  { SHAPE_TRAPEZOID,  200,      1500 },   // PROFILE_BRISK
+  { SHAPE_EASE,       150,      1000 },   // PROFILE_EASE
+  { SHAPE_EASE,       60,       300  }    // PROFILE_GENTLE
+};
 
 //
 // Implementation for the moveSequence class
 //
+// The position last written to each servo is tracked (its pose) and every move starts from
+// there, whatever start angle the table gives.  That way a move never begins with a jump, 
+// and a group that takes over from one that was stopped part way through carries on from 
+// wherever the servos actually are.
+//
 
 moveSequence::moveSequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd):sequence(pSeqTable, aSeqType, aSeqEnd)
 {
-  startSequence();
+  startSequence(millis());
 }
 
 moveSequence::moveSequence(const void* pSeqTable):sequence(pSeqTable, PRIMARY_SEQ, ONE_SHOT)
 {
-  startSequence();
+  startSequence(millis());
 }
 
 void moveSequence::setup()
 {
+#ifdef SERVO_PCA9685
+  s_servoChip.setup(servoChipHz);
+#else
   // Attach servos to their pins
-  moveSequence::armServo.attach(moveSequence::armServoPin);
-  moveSequence::lidServo.attach(moveSequence::lidServoPin);
+  moveSequence::armServo.attach(moveSequence::armServoPin, servoMinUs, servoMaxUs);
+  moveSequence::lidServo.attach(moveSequence::lidServoPin, servoMinUs, servoMaxUs);
+  s_axes[LID_AXIS].pServo = &lidServo;
+  s_axes[ARM_AXIS].pServo = &armServo;
+#endif
   
   // Move servos to a known position
-  moveSequence::armServo.write(moveSequence::armRetractedAngle);
-  moveSequence::lidServo.write(moveSequence::lidClosedAngle);
+  writeAxis(ARM_AXIS, angleToUs(armRetractedAngle));
+  writeAxis(LID_AXIS, angleToUs(lidClosedAngle));
+  flush();
 }
 
-void moveSequence::startSequence()
+//
+// flush
+//
+// Sends the servo positions written since the last call.  Called once per pass of loop().
+// Nothing to do with the Servo library, which picks up a new position by itself.
+//
+
+void moveSequence::flush()
 {
+#ifdef SERVO_PCA9685
+  s_servoChip.flush();
+#endif
+}
+
+//
+// testPosition
+//
+// Test mode: lid fully opened and arm fully extended so the control horns can be fitted
+//
+
+void moveSequence::testPosition()
+{
+  writeAxis(LID_AXIS, angleToUs(lidOpenedAngle));
+  flush();
+  delay(1000);
+  writeAxis(ARM_AXIS, angleToUs(armExtendedAngle));
+  flush();
+}
+
+void moveSequence::startSequence(uint32_t startMs)
+{
+  // This sequence takes the servos over from wherever they are, including part way home
+  s_homing = false;
+  s_strikePending = false;
+
   // Call base class
-  sequence::startSequence();
+  sequence::startSequence(startMs);
 }
 
+//
+// stopSequence
+//
+// Rather than snapping the servos home, which jerks them and draws a current spike, they
+// glide home from wherever they are.  The arm comes in first and the lid starts closing once
+// the arm is nearly home so it can't close on it.  The glide is driven by serviceHoming() 
+// and is abandoned as soon as another move sequence starts, which then blends straight on 
+// from the current pose.
+//
+
 void moveSequence::stopSequence() 
 {
-  // Move the servos to a known position
-  armServo.write(armRetractedAngle);
-  lidServo.write(lidClosedAngle);
+  int armAwayDeg = abs(usToAngle(s_axes[ARM_AXIS].poseUs) - armRetractedAngle);
+  uint8_t phaseDeg = (armAwayDeg > homingClearanceDeg) ? armAwayDeg - homingClearanceDeg : 0;
+
+  coordinatedPlan(ARM_AXIS, armRetractedAngle, lidClosedAngle, PROFILE_BRISK, phaseDeg, millis());
+  s_homingDeadlineMs = millis();
+  s_homing = true;
   
   // Call base class
   sequence::stopSequence();
 }
 
+//
+// serviceHoming
+//
+// Moves the servos along their glide home, if there is one.  Call every time loop() is 
+// executed.
+//
+
+void moveSequence::serviceHoming()
+{
+  if (!s_homing || static_cast<int32_t> (millis() - s_homingDeadlineMs) < 0) return;
+
+  uint32_t now = millis();
+  bool lidHome = profileUpdate(s_axes[LID_AXIS], now);
+  bool armHome = profileUpdate(s_axes[ARM_AXIS], now);
+
+  if (lidHome && armHome) s_homing = false;
+  else s_homingDeadlineMs = now + profileTickMs;
+}
+
+//
+// Returns the millis() value at which serviceHoming() next has something to do
+//
+
+uint32_t moveSequence::getHomingDeadline()
+{
+  if (!s_homing) return millis() + 0x7FFFFFFF;
+  return s_homingDeadlineMs;
+}
+
 void moveSequence::prepareAction()
 {
+  ProfileSection(PROF_MOVE_PREPARE);
   int peekAngle;
   
+  // Log the moves and delays
+  if (m_seqEntry.action > ACTION_LAST_GENERIC || m_seqEntry.action == ACTION_DELAY)
+  {
+    Trace(TR_MOVE_ACTION, static_cast<uint8_t> (m_seqEntry.action));
+  }
+
   // Prepare action
   switch (m_seqEntry.action)
   {
     // These cases will be executed immediately when the move is processed.
     case ACTION_OPEN_LID:
-      DebugPrintln(F("ACTION_OPEN_LID"));
-      m_pServo = &lidServo;
+      m_axis = LID_AXIS;
       m_seqEntry.data1 = lidOpenedAngle;
       break;
 
     case ACTION_CLOSE_LID:
-      DebugPrintln(F("ACTION_CLOSE_LID"));
-      m_pServo = &lidServo;
+      m_axis = LID_AXIS;
       m_seqEntry.data1 = lidClosedAngle;
       break;
 
     case ACTION_EXTEND_ARM:
-      DebugPrintln(F("ACTION_EXTEND_ARM"));
-      m_pServo = &armServo;
+      m_axis = ARM_AXIS;
       m_seqEntry.data1 = armExtendedAngle;
       break;
 
     case ACTION_RETRACT_ARM:
-      DebugPrintln(F("ACTION_RETRACT_ARM"));
-      m_pServo = &armServo;
+      m_axis = ARM_AXIS;
       m_seqEntry.data1 = armRetractedAngle;
       break;
 
     case ACTION_MOVE_LID:
-      DebugPrintln(F("ACTION_MOVE_LID"));
-      moveServoInit(&lidServo, m_seqEntry.data1, m_seqEntry.data2, m_seqEntry.data3);
+      moveServoInit(LID_AXIS, m_seqEntry.data2, m_seqEntry.data3);
       break;
 
     case ACTION_PEEK_LID_FROM_CLOSE:
-      DebugPrintln(F("ACTION_PEEK_LID_FROM_CLOSE"));
       // In this case data1 is the "peek" degrees.  It is the number of degrees to adjust the 
       // fully closed position to deduce the "peek" angle.
       if (lidClosedAngle > lidOpenedAngle)
@@ -127,58 +238,68 @@ void moveSequence::prepareAction()
         peekAngle = lidClosedAngle + m_seqEntry.data1;
       }
       
-      moveServoInit(&lidServo, lidClosedAngle, peekAngle, m_seqEntry.data2);
+      moveServoInit(LID_AXIS, peekAngle, m_seqEntry.data2);
       break;
 
     case ACTION_CLOSE_LID_FROM_PEEK:
-      DebugPrintln(F("ACTION_PEEK_LID_FROM_CLOSE"));
-      // In this case data1 is the "peek" degrees.  It is the number of degrees to adjust the 
-      // fully open position to deduce the "peek" angle.
-      if (lidClosedAngle > lidOpenedAngle)
-      {
-        peekAngle = lidClosedAngle - m_seqEntry.data1;
-      }
-      else
-      {
-        peekAngle = lidClosedAngle + m_seqEntry.data1;
-      }
-      
-      moveServoInit(&lidServo, peekAngle, lidClosedAngle, m_seqEntry.data2);
+      // The lid closes from wherever it is so the "peek" degrees (data1) aren't needed
+      moveServoInit(LID_AXIS, lidClosedAngle, m_seqEntry.data2);
       break;
 
     case ACTION_OPEN_LID_FROM_CLOSE:
-      DebugPrintln(F("ACTION_OPEN_LID_FROM_CLOSE"));
-      moveServoInit(&lidServo, lidClosedAngle, lidOpenedAngle, m_seqEntry.data1);
+      moveServoInit(LID_AXIS, lidOpenedAngle, m_seqEntry.data1);
       break;
 
     case ACTION_CLOSE_LID_FROM_OPEN:
-      DebugPrintln(F("ACTION_CLOSE_LID_FROM_OPEN"));
-      moveServoInit(&lidServo, lidOpenedAngle, lidClosedAngle, m_seqEntry.data1);
+      moveServoInit(LID_AXIS, lidClosedAngle, m_seqEntry.data1);
       break;
 
     case ACTION_MOVE_ARM:
-      DebugPrintln(F("ACTION_MOVE_ARM"));
-      moveServoInit(&armServo, m_seqEntry.data1, m_seqEntry.data2, m_seqEntry.data3);
+      moveServoInit(ARM_AXIS, m_seqEntry.data2, m_seqEntry.data3);
       break;
 
     case ACTION_EXTEND_ARM_FROM_RETRACTED:
-      DebugPrintln(F("ACTION_EXTEND_ARM_FROM_RETRACTED"));
-      moveServoInit(&armServo, armRetractedAngle, armExtendedAngle, m_seqEntry.data1);
+      moveServoInit(ARM_AXIS, armExtendedAngle, m_seqEntry.data1);
       break;
 
     case ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED:
-      DebugPrintln(F("ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED"));
-      moveServoInit(&armServo, armRetractedAngle, armAlmostExtendedAngle, m_seqEntry.data1);
+      moveServoInit(ARM_AXIS, armAlmostExtendedAngle, m_seqEntry.data1);
       break;
 
     case ACTION_RETRACT_ARM_FROM_EXTENDED:
-      DebugPrintln(F("ACTION_RETRACT_ARM_FROM_EXTENDED"));
-      moveServoInit(&armServo, armExtendedAngle, armRetractedAngle, m_seqEntry.data1);
+      moveServoInit(ARM_AXIS, armRetractedAngle, m_seqEntry.data1);
+      break;
+
+    case ACTION_PROFILE_LID:
+      profilePlan(s_axes[LID_AXIS], m_seqEntry.data2, m_seqEntry.data3);
+      s_axes[LID_AXIS].startMs = m_deadlineMs;
+      s_profileEndMs = m_deadlineMs + s_axes[LID_AXIS].scaledMs;
+      break;
+
+    case ACTION_PROFILE_ARM:
+      // The switch off attempt is made as the arm gets there (see profileServo())
+      s_strikePending = (m_seqEntry.data2 == armExtendedAngle);
+      profilePlan(s_axes[ARM_AXIS], m_seqEntry.data2, m_seqEntry.data3);
+      s_axes[ARM_AXIS].startMs = m_deadlineMs;
+      s_profileEndMs = m_deadlineMs + s_axes[ARM_AXIS].scaledMs;
+      break;
+
+    case ACTION_PROFILE_LID_ARM:
+      // Angles are packed start | end << 8, data3 is profile | phase << 8
+      s_strikePending = ((m_seqEntry.data2 >> 8) == armExtendedAngle);
+      coordinatedPlan(LID_AXIS, m_seqEntry.data1 >> 8, m_seqEntry.data2 >> 8, 
+                      m_seqEntry.data3 & 0xFF, m_seqEntry.data3 >> 8, m_deadlineMs);
+      break;
+
+    case ACTION_PROFILE_ARM_LID:
+      // Angles are packed start | end << 8, data3 is profile | phase << 8
+      s_strikePending = ((m_seqEntry.data1 >> 8) == armExtendedAngle);
+      coordinatedPlan(ARM_AXIS, m_seqEntry.data1 >> 8, m_seqEntry.data2 >> 8, 
+                      m_seqEntry.data3 & 0xFF, m_seqEntry.data3 >> 8, m_deadlineMs);
       break;
 
     // If not a movement then assume this is a generic action  
     default:
-      if (m_seqEntry.action == ACTION_DELAY) DebugPrintln(F("ACTION_DELAY"));
       // Call base class if we don't process the action
       sequence::prepareAction();
   }
@@ -186,23 +307,25 @@ void moveSequence::prepareAction()
 
 sequence::actionState moveSequence::executeAction()
 {
+  ProfileSection(PROF_MOVE_EXECUTE);
   switch (m_seqEntry.action)
   {
     case ACTION_EXTEND_ARM:
-        m_switchOffAttempted = true; // indicate this move should turn the switch off
-        // fall through on purpose!
     case ACTION_OPEN_LID:
     case ACTION_CLOSE_LID:
     case ACTION_RETRACT_ARM:
       // These actions are immediate actions and require no further information.  This move
       // is completed.
-      m_pServo->write(m_seqEntry.data1);
+      writeAxis(m_axis, angleToUs(m_seqEntry.data1));
+      // The servo is sent straight to the switch, so there is no telling when the arm gets 
+      // there: the strike is taken as when it is commanded
+      if (m_seqEntry.action == ACTION_EXTEND_ARM) attemptSwitchOff();
       return ACTION_COMPLETE;
 
     case ACTION_EXTEND_ARM_FROM_RETRACTED:
       if (moveServo() == ACTION_COMPLETE)
       {
-        m_switchOffAttempted = true;  // indicate this move should turn the switch off
+        attemptSwitchOff();  // indicate this move should turn the switch off
         return ACTION_COMPLETE;
       }
       break;
@@ -220,6 +343,13 @@ sequence::actionState moveSequence::executeAction()
       return moveServo();
       break;
 
+    case ACTION_PROFILE_LID:
+    case ACTION_PROFILE_ARM:
+    case ACTION_PROFILE_LID_ARM:
+    case ACTION_PROFILE_ARM_LID:
+      // Profiled moves are driven from the elapsed time of the move (see profileServo())
+      return profileServo();
+
     // If not a movement then assume this is a generic action  
     default:
       // call base class
@@ -235,19 +365,20 @@ sequence::actionState moveSequence::executeAction()
 // moveServoInit
 //
 // This is a convenience function to initialize values in the current move information structure.
+// The move starts from the servo's current pose.
 //  
 
-void moveSequence::moveServoInit(Servo* pServo, int startAngle, int endAngle, int degDelay)
+void moveSequence::moveServoInit(axisType axis, int endAngle, int degDelay)
 {
-  m_pServo = pServo;              // Servo we are moving
+  m_axis = axis;                  // Servo we are moving
   
   // These values originally came from the current sequence entry (action).  We are re-using them
   // in order to save RAM since the base class declares these for each object.  Sacrificing a little
   // readability to save memory.
-  m_seqEntry.data1 = startAngle;  // degree counter. init'ed to the starting angle
+  m_seqEntry.data1 = usToAngle(s_axes[axis].poseUs);  // degree counter. init'ed to the current angle
   m_seqEntry.data2 = endAngle;
   m_seqEntry.data3 = degDelay;
-  m_prevMillis = millis();  // used for timing delay
+  m_deadlineMs += degDelay; // first 1 degree step
 }
 
 //
@@ -261,11 +392,8 @@ void moveSequence::moveServoInit(Servo* pServo, int startAngle, int endAngle, in
 sequence::actionState moveSequence::moveServo()
 {
   // If there is no delay or the delay has expired then move the servo 1 degree and check for move completion.
-  if (m_seqEntry.data3 == 0 || millis() - m_prevMillis > m_seqEntry.data3)
+  if (m_seqEntry.data3 == 0 || deadlineReached())
   {
-    // Prepare for next delay
-    m_prevMillis = millis();
-
     // Increment or decrement the angle based on the direction we are moving
     if (m_seqEntry.data1 < m_seqEntry.data2)
     {
@@ -277,14 +405,313 @@ sequence::actionState moveSequence::moveServo()
     }
     else // angles are equal, therefore move is done!
     {
-      // Current angle and end angle are equal
+      // Current angle and end angle are equal.  The next action is timed from this deadline.
       return ACTION_COMPLETE;
     }
     
     // Move it!!!
-    m_pServo->write(m_seqEntry.data1);
+    writeAxis(m_axis, angleToUs(m_seqEntry.data1));
+
+    // Prepare for next delay
+    advanceDeadline(m_seqEntry.data3);
   }
 
   // If we got to here the move is still executing.
   return ACTION_EXECUTING;
-}
\ No newline at end of file
+}
+
+//
+// coordinatedPlan
+//
+// Plans a profiled move of both servos.  The leader starts at 'startMs' and the follower 
+// starts once the leader has travelled the phase offset (degrees), e.g. the arm can start
+// out as soon as the lid is far enough open.  If the follower would get there before the 
+// leader it is slowed down so the two arrive together; the leader is never slowed down to 
+// wait for the follower.  Both axes use the same profile.
+//
+
+void moveSequence::coordinatedPlan(axisType leader, int leaderEnd, int followerEnd, uint8_t profile, uint8_t phaseDeg, uint32_t startMs)
+{
+  profileState& lead = s_axes[leader];
+  profileState& follow = s_axes[leader == LID_AXIS ? ARM_AXIS : LID_AXIS];
+  uint32_t phaseUs = static_cast<uint32_t> (phaseDeg)*(servoMaxUs - servoMinUs)/180;
+  uint32_t phaseMs;
+
+  profilePlan(lead, leaderEnd, profile);
+  profilePlan(follow, followerEnd, profile);
+
+  // Find when the leader passes the phase offset (binary search on its travel, which only 
+  // ever increases)
+  if (phaseUs >= static_cast<uint32_t> (abs(lead.distanceUs)))
+  {
+    phaseMs = lead.totalMs;
+  }
+  else
+  {
+    uint32_t loMs = 0;
+    phaseMs = lead.totalMs;
+    while (loMs < phaseMs)
+    {
+      uint32_t midMs = (loMs + phaseMs)/2;
+      if (profileTravelUs(lead, midMs) >= phaseUs) phaseMs = midMs;
+      else loMs = midMs + 1;
+    }
+  }
+
+  // Synchronized arrival, as long as that doesn't hold up the leader
+  if (follow.totalMs < lead.totalMs - phaseMs) follow.scaledMs = lead.totalMs - phaseMs;
+
+  lead.startMs = startMs;
+  follow.startMs = startMs + phaseMs;
+  s_profileEndMs = follow.startMs + follow.scaledMs;
+  if (static_cast<int32_t> (lead.startMs + lead.scaledMs - s_profileEndMs) > 0) s_profileEndMs = lead.startMs + lead.scaledMs;
+}
+
+//
+// profilePlan
+//
+// Works out the timing of a profiled move from the servo's current pose to 'endAngle' using 
+// the limits of the chosen profile.  All of the arithmetic is integer; the square roots only
+// happen here, once per move.  Distances are in thousandths of a degree.
+//
+//   Trapezoid: accelerate at maxAccel until maxVelocity, cruise, then decelerate the same way.
+//              If the move is too short to reach maxVelocity it is all acceleration and 
+//              deceleration.
+//   Ease:      3u^2 - 2u^3 of the distance at fraction u of the move time.  That peaks at 
+//              1.5x the average velocity and 6*D/T^2 acceleration, so the move takes as long as
+//              the tighter of the two limits needs.
+//
+
+void moveSequence::profilePlan(profileState& axis, int endAngle, uint8_t profile)
+{
+  uint32_t maxVelocity = pgm_read_word_near(&motionProfiles[profile].maxVelocity);
+  uint32_t maxAccel = pgm_read_word_near(&motionProfiles[profile].maxAccel);
+  uint32_t totalMs = 0;
+
+  axis.shape = pgm_read_byte_near(&motionProfiles[profile].shape);
+  axis.startUs = axis.poseUs;
+  axis.distanceUs = angleToUs(endAngle) - axis.startUs;
+  axis.accelUs = 0;
+  axis.accelMs = 0;
+  axis.cruiseMs = 0;
+
+  uint32_t distanceUs = abs(axis.distanceUs);
+  uint32_t distanceMilliDeg = distanceUs*180000UL/(servoMaxUs - servoMinUs);
+
+  if (distanceMilliDeg == 0)
+  {
+    // Nothing to do; the first update finishes the move
+  }
+  else if (axis.shape == SHAPE_EASE)
+  {
+    uint32_t accelLimitMs = isqrt(6000UL*distanceMilliDeg/maxAccel);
+    totalMs = 3*distanceMilliDeg/(2*maxVelocity);
+    if (accelLimitMs > totalMs) totalMs = accelLimitMs;
+  }
+  else // SHAPE_TRAPEZOID
+  {
+    uint32_t accelMs = 1000*maxVelocity/maxAccel;
+    uint32_t accelMilliDeg = maxVelocity*accelMs/2;
+    uint32_t cruiseMs = 0;
+
+    if (2*accelMilliDeg >= distanceMilliDeg)
+    {
+      // Never reaches maxVelocity.  Accelerate for half the distance.
+      accelMs = isqrt(1000UL*distanceMilliDeg/maxAccel);
+      accelMilliDeg = distanceMilliDeg/2;
+    }
+    else
+    {
+      cruiseMs = (distanceMilliDeg - 2*accelMilliDeg)/maxVelocity;
+    }
+    if (accelMs == 0) accelMs = 1;
+
+    axis.accelMs = accelMs;
+    axis.cruiseMs = cruiseMs;
+    axis.accelUs = distanceUs*accelMilliDeg/distanceMilliDeg;
+    totalMs = 2*accelMs + cruiseMs;
+  }
+  axis.totalMs = (totalMs > 0xFFFF) ? 0xFFFF : totalMs;
+  axis.scaledMs = axis.totalMs;
+}
+
+//
+// profileTravelUs
+//
+// Distance (us, always positive) the profile has covered 'elapsedMs' into the move, at the
+// profile's own timing
+//
+
+uint16_t moveSequence::profileTravelUs(const profileState& axis, uint32_t elapsedMs)
+{
+  uint32_t distanceUs = abs(axis.distanceUs);
+  uint32_t u;
+
+  if (elapsedMs >= axis.totalMs) return distanceUs;
+
+  if (axis.shape == SHAPE_EASE)
+  {
+    u = (elapsedMs << 8)/axis.totalMs;             // fraction of the move (x256)
+    return (distanceUs*((u*u*(768 - 2*u)) >> 8)) >> 16;
+  }
+  if (elapsedMs < axis.accelMs)
+  {
+    // Accelerating
+    u = (elapsedMs << 8)/axis.accelMs;
+    return (axis.accelUs*u*u) >> 16;
+  }
+  if (elapsedMs < static_cast<uint32_t> (axis.accelMs + axis.cruiseMs))
+  {
+    // Cruising
+    return axis.accelUs + (distanceUs - 2*axis.accelUs)*(elapsedMs - axis.accelMs)/axis.cruiseMs;
+  }
+
+  // Decelerating (mirror image of accelerating)
+  u = ((axis.totalMs - elapsedMs) << 8)/axis.accelMs;
+  return distanceUs - ((axis.accelUs*u*u) >> 16);
+}
+
+//
+// profileUpdate
+//
+// Positions one servo where its profile says it should be at 'now'.  The position is always
+// worked out from the time since the move started, so a late update just lands further 
+// along the curve rather than stretching the move.  Returns true once the servo has arrived.
+//
+
+bool moveSequence::profileUpdate(profileState& axis, uint32_t now)
+{
+  axisType axisIndex = (&axis == &s_axes[LID_AXIS]) ? LID_AXIS : ARM_AXIS;
+
+  // A follower that hasn't started yet stays where it is
+  if (static_cast<int32_t> (now - axis.startMs) < 0) return false;
+
+  uint32_t elapsedMs = now - axis.startMs;
+  if (elapsedMs >= axis.scaledMs)
+  {
+    // Land exactly on the end angle
+    writeAxis(axisIndex, axis.startUs + axis.distanceUs);
+    return true;
+  }
+
+  // Map onto the profile's own timing when it is being spread over a longer time
+  if (axis.scaledMs != axis.totalMs) elapsedMs = elapsedMs*axis.totalMs/axis.scaledMs;
+
+  uint16_t travelUs = profileTravelUs(axis, elapsedMs);
+  if (axis.distanceUs < 0) writeAxis(axisIndex, axis.startUs - travelUs);
+  else writeAxis(axisIndex, axis.startUs + travelUs);
+  return false;
+}
+
+//
+// profileServo
+//
+// Updates the servo(s) moved by the current profiled action every profileTickMs.  The action 
+// is complete once they have all arrived and the next action is timed from the planned end
+// of this one.  A move that extends the arm attempts to turn the switch off once the arm is
+// within strikeDeg of armExtendedAngle, which is where it flips the switch (an eased move 
+// covers the last few degrees slowly, so this can be tens of ms before it arrives).
+//
+
+sequence::actionState moveSequence::profileServo()
+{
+  if (!deadlineReached()) return ACTION_EXECUTING;
+
+  uint32_t now = millis();
+  uint8_t firstAxis = (m_seqEntry.action == ACTION_PROFILE_ARM) ? ARM_AXIS : LID_AXIS;
+  uint8_t lastAxis = (m_seqEntry.action == ACTION_PROFILE_LID) ? LID_AXIS : ARM_AXIS;
+  bool arrived = true;
+
+  for (uint8_t i = firstAxis; i <= lastAxis; i++)
+  {
+    if (!profileUpdate(s_axes[i], now)) arrived = false;
+  }
+
+  if (s_strikePending)
+  {
+    if (arrived || abs(usToAngle(s_axes[ARM_AXIS].poseUs) - armExtendedAngle) <= strikeDeg)
+    {
+      s_strikePending = false;
+      attemptSwitchOff();
+    }
+  }
+
+  if (arrived)
+  {
+    m_deadlineMs = s_profileEndMs;
+    return ACTION_COMPLETE;
+  }
+
+  // Next update, but no later than the end of the move
+  advanceDeadline(profileTickMs);
+  if (static_cast<int32_t> (m_deadlineMs - s_profileEndMs) > 0) m_deadlineMs = s_profileEndMs;
+
+  return ACTION_EXECUTING;
+}
+
+//
+// writeAxis
+//
+// Every servo write goes through here so the pose is always what the servo was last told
+//
+
+void moveSequence::writeAxis(axisType axis, int us)
+{
+  reactionTimer::servoWrite();
+  s_axes[axis].poseUs = us;
+#ifdef SERVO_PCA9685
+  s_servoChip.write(axis, s_servoChip.usToCount(us));
+#else
+  s_axes[axis].pServo->writeMicroseconds(us);
+#endif
+}
+
+//
+// angleToUs
+//
+// Servo pulse width for an angle, the same mapping Servo::write() uses
+//
+
+int moveSequence::angleToUs(int angle)
+{
+  return servoMinUs + static_cast<int32_t> (angle)*(servoMaxUs - servoMinUs)/180;
+}
+
+//
+// usToAngle
+//
+// Nearest angle to a servo pulse width
+//
+
+int moveSequence::usToAngle(int us)
+{
+  return (static_cast<int32_t> (us - servoMinUs)*180 + (servoMaxUs - servoMinUs)/2)/(servoMaxUs - servoMinUs);
+}
+
+//
+// isqrt
+//
+// Integer square root (bit by bit, no division)
+//
+
+uint16_t moveSequence::isqrt(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > value) bit >>= 2;
+  while (bit != 0)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
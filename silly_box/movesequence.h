@@ -27,9 +27,21 @@
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 #pragma once
-#include <Servo.h>
 #include "sequence.h"
 #include "proximity.h"
+#include "reactiontimer.h"
+
+// Servo hardware.  Define SERVO_PCA9685 to drive the servos from a PCA9685 PWM chip over I2C
+// instead of with the Servo library.  The chip makes the pulses so they no longer jitter
+// when interrupts are held off, and Timer1 is left free.
+
+//#define SERVO_PCA9685
+
+#ifdef SERVO_PCA9685
+#include "pca9685.h"
+#else
+#include <Servo.h>
+#endif
 
 //
 // This sequence class handles the movement of the arm and lid servos.
@@ -38,20 +50,88 @@
 class moveSequence: public sequence
 {
   public:
-    // Servos
-    static Servo armServo;
-    static Servo lidServo;
-
     static const int lidClosedAngle = 170;
     static const int lidOpenedAngle = 130;
     static const int armRetractedAngle = 180;
     static const int armExtendedAngle = 9;
     static const int armAlmostExtendedAngle = armExtendedAngle + 11;
 
+    // Servo pulse widths (us) at 0 and 180 degrees.  The servos are attached with these so
+    // write() and writeMicroseconds() agree on what an angle is.
+    static const int servoMinUs = 544;
+    static const int servoMaxUs = 2400;
+
   private:
     // Constants
+#ifdef SERVO_PCA9685
+    // The chip's channel for each servo is its axisType
+    static const uint8_t servoChipAddress = 0x40;
+    static const uint16_t servoChipHz = 50;
+#else
     static const int armServoPin = 5;
     static const int lidServoPin = 6;
+#endif
+    static const uint8_t profileTickMs = 5;  // how often a profiled move updates the servo
+    static const uint8_t strikeDeg = 5;      // the arm flips the switch this far short of armExtendedAngle
+    static const uint8_t homingClearanceDeg = 20; // lid starts closing when the arm is this far from home
+
+    // Motion profile limits (see PROFILE_XXX in action.h)
+    enum profileShape
+    {
+      SHAPE_TRAPEZOID,
+      SHAPE_EASE
+    };
+
+    struct motionProfile
+    {
+      uint8_t shape;
+      uint16_t maxVelocity;   // deg/s
+      uint16_t maxAccel;      // deg/s/s
+    };
+
+    static const motionProfile motionProfiles[] PROGMEM;
+
+    // Pose and profiled move in progress, one per servo.  Positions are servo pulse width 
+    // (us) and times are ms.  Only one move sequence runs at a time (they all share the two
+    // servos) so these are shared rather than carried by every object.
+    enum axisType
+    {
+      LID_AXIS,
+      ARM_AXIS,
+      NUM_AXES
+    };
+
+    struct profileState
+    {
+#ifndef SERVO_PCA9685
+      Servo* pServo;
+#endif
+      int16_t poseUs;         // last position written to the servo
+      uint8_t shape;
+      int16_t startUs;
+      int16_t distanceUs;     // signed, end - start
+      uint16_t accelUs;       // distance covered while accelerating (trapezoid only)
+      uint16_t accelMs;       // time spent accelerating (trapezoid only)
+      uint16_t cruiseMs;      // time spent at maximum velocity (trapezoid only)
+      uint16_t totalMs;       // length of the move at the profile's limits
+      uint16_t scaledMs;      // length it is actually spread over (>= totalMs)
+      uint32_t startMs;
+    };
+
+#ifdef SERVO_PCA9685
+    static pca9685 s_servoChip;
+#else
+    static Servo armServo;
+    static Servo lidServo;
+#endif
+
+    static profileState s_axes[NUM_AXES];
+    static uint32_t s_profileEndMs;  // when the last axis of the current action arrives
+    static bool s_strikePending;     // the current profiled action ends with the arm extended
+
+    // Glide home after a group is stopped (see stopSequence())
+    static bool s_homing;
+    static uint32_t s_homingDeadlineMs;
 
   // Construction/Destruction
   public:
@@ -61,18 +141,32 @@ class moveSequence: public sequence
   // Methods
   public:
     static void setup();
-    void startSequence();
+    static void flush();
+    static void testPosition();
+    static void serviceHoming();
+    static uint32_t getHomingDeadline();
+    void startSequence(uint32_t startMs);
     void stopSequence();
 
   private:
     actionState executeAction();
     void prepareAction();
-    void moveServoInit(Servo* pServo, int startAngle, int endAngle, int degDelay);
+    void moveServoInit(axisType axis, int endAngle, int degDelay);
     actionState moveServo();
+    actionState profileServo();
+    void attemptSwitchOff() { m_switchOffAttempted = true; reactionTimer::strike(); }
+    static void profilePlan(profileState& axis, int endAngle, uint8_t profile);
+    static void coordinatedPlan(axisType leader, int leaderEnd, int followerEnd, uint8_t profile, uint8_t phaseDeg, uint32_t startMs);
+    static uint16_t profileTravelUs(const profileState& axis, uint32_t elapsedMs);
+    static bool profileUpdate(profileState& axis, uint32_t now);
+    static void writeAxis(axisType axis, int us);
+    static int angleToUs(int angle);
+    static int usToAngle(int us);
+    static uint16_t isqrt(uint32_t);
 
   // Attributes
   private:
     // Additional context for processing servo actions
-    Servo* m_pServo;
+    axisType m_axis;
 };
 
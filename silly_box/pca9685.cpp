@@ -0,0 +1,138 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the pca9685 class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "pca9685.h"
+#include <Wire.h>
+
+pca9685::pca9685(uint8_t address)
+{
+  m_address = address;
+  m_prescale = 0;
+  m_changed = 0;
+  m_bytesSent = 0;
+  memset(m_count, 0, sizeof(m_count));
+}
+
+//
+// setup
+//
+// Sets the chip up with all outputs off and the PWM running at frequencyHz (24 - 1526Hz)
+//
+
+void pca9685::setup(uint16_t frequencyHz)
+{
+  Wire.begin();
+  Wire.setClock(i2cClockHz);
+
+  // The prescaler can only be changed while the oscillator is asleep
+  m_prescale = (oscillatorHz + 2048UL*frequencyHz)/(4096UL*frequencyHz) - 1;
+  writeRegister(MODE1, MODE1_SLEEP);
+  writeRegister(PRE_SCALE, m_prescale);
+  writeRegister(MODE2, MODE2_OUTDRV);
+  writeRegister(MODE1, MODE1_AI);
+  delayMicroseconds(500);                        // oscillator start up
+  writeRegister(MODE1, MODE1_AI | MODE1_RESTART);
+
+  // Every OFF count (and the ON counts) are zero after a reset, which is what m_count says
+  m_changed = 0xFFFF;
+  flush();
+}
+
+//
+// write
+//
+// Sets a channel's pulse width, 0 - maxCount counts of the 4096 count period.  Sent by the
+// next flush() if it is a change.
+//
+
+void pca9685::write(uint8_t channel, uint16_t count)
+{
+  if (m_count[channel] == count) return;
+
+  m_count[channel] = count;
+  m_changed |= 1U << channel;
+}
+
+//
+// usToCount
+//
+// Pulse width in counts for a width in microseconds, e.g. for a servo.  Worked out from the
+// prescaler actually in use rather than the requested frequency since that is rounded.
+//
+
+uint16_t pca9685::usToCount(uint16_t us)
+{
+  return static_cast<uint32_t> (us)*(oscillatorHz/1000000UL)/(m_prescale + 1);
+}
+
+//
+// flush
+//
+// Sends the channels that have changed since the last flush.  Unchanged channels in between
+// changed ones are sent again rather than starting another transfer, which would cost more.
+//
+
+void pca9685::flush()
+{
+  if (m_changed == 0) return;
+
+  uint8_t first = 0;
+  uint8_t last = numChannels - 1;
+  while (!(m_changed & (1U << first))) first++;
+  while (!(m_changed & (1U << last))) last--;
+
+  while (first <= last)
+  {
+    uint8_t end = min(last, first + maxTransferChannels - 1);
+
+    Wire.beginTransmission(m_address);
+    Wire.write(LED0_OFF_L + 4*first);
+    for (uint8_t i = first; i <= end; i++)
+    {
+      if (i != first)
+      {
+        // ON count
+        Wire.write(0);
+        Wire.write(0);
+      }
+      Wire.write(m_count[i] & 0xFF);
+      Wire.write(m_count[i] >> 8);
+    }
+    Wire.endTransmission();
+    m_bytesSent += 4 + 4*(end - first);          // address, register and the counts
+
+    first = end + 1;
+  }
+  m_changed = 0;
+}
+
+void pca9685::writeRegister(uint8_t reg, uint8_t value)
+{
+  Wire.beginTransmission(m_address);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+  m_bytesSent += 3;
+}
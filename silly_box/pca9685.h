@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// pca9685 class drives a PCA9685 16 channel, 12 bit PWM chip over I2C.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// write() only changes a copy of the chip's registers; flush() sends the channels that
+// changed in as few I2C transfers as possible, normally one.  The chip's auto increment 
+// lets a transfer run on from the first changed channel to the last.  Every channel's ON 
+// count is left at 0 so only the OFF count (the pulse width) is ever written.
+//
+// The chip has one PWM frequency for all 16 channels so servos (50Hz) and LEDs (which 
+// flicker at 50Hz) need a chip each.  Give them different addresses with the A0 - A5 
+// jumpers.
+//
+
+class pca9685
+{
+  public:
+    static const uint8_t numChannels = 16;
+    static const uint16_t maxCount = 4095;
+
+  private:
+    static const uint32_t oscillatorHz = 25000000;  // internal oscillator, +/- a few %
+    static const uint32_t i2cClockHz = 400000;
+
+    // Registers
+    static const uint8_t MODE1 = 0x00;
+    static const uint8_t MODE2 = 0x01;
+    static const uint8_t LED0_OFF_L = 0x08;
+    static const uint8_t PRE_SCALE = 0xFE;
+
+    static const uint8_t MODE1_RESTART = 0x80;
+    static const uint8_t MODE1_AI = 0x20;        // register auto increment
+    static const uint8_t MODE1_SLEEP = 0x10;
+    static const uint8_t MODE2_OUTDRV = 0x04;    // totem pole outputs
+
+    // Channels per transfer.  The Wire library buffers 32 bytes: the register number, 
+    // OFF_L and OFF_H of the first channel then ON_L, ON_H, OFF_L and OFF_H of each of the 
+    // rest.
+    static const uint8_t maxTransferChannels = 8;
+
+  // Construction/Destruction
+  public:
+    pca9685(uint8_t address);
+
+  // Methods
+  public:
+    void setup(uint16_t frequencyHz);
+    void write(uint8_t channel, uint16_t count);
+    uint16_t usToCount(uint16_t us);
+    void flush();
+    uint32_t getBytesSent() { return m_bytesSent; }
+
+  private:
+    void writeRegister(uint8_t reg, uint8_t value);
+
+  // Attributes
+  private:
+    uint8_t m_address;
+    uint8_t m_prescale;
+    uint16_t m_count[numChannels];   // OFF count of each channel, as last written
+    uint16_t m_changed;              // one bit per channel
+    uint32_t m_bytesSent;            // I2C bytes, including the address bytes
+};
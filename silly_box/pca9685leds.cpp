@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the pca9685Leds class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "pca9685leds.h"
+#include "color.h"
+
+pca9685 pca9685Leds::s_chip(chipAddress);
+uint32_t pca9685Leds::s_color[numPixels];
+
+void pca9685Leds::setup()
+{
+  static_assert(numPixels*3 <= pca9685::numChannels, "too many LEDs for one PCA9685");
+  s_chip.setup(pwmHz);
+}
+
+//
+// setPixel
+//
+// Hands the components of a color that have changed to the chip, through the gamma table
+//
+
+void pca9685Leds::setPixel(uint8_t pixel, uint32_t color)
+{
+  uint32_t changed = s_color[pixel] ^ color;
+
+  s_color[pixel] = color;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    uint8_t shift = 16 - 8*i;   // red, green then blue
+    if ((changed >> shift) & 0xff)
+    {
+      // Stretch the 8 bit value to the chip's 12 bits so 255 is fully on
+      uint16_t value = pgm_read_byte_near(&gammaTable[(color >> shift) & 0xff]);
+      s_chip.write(pixel*3 + i, (value << 4) | (value >> 4));
+    }
+  }
+}
+
+bool pca9685Leds::flush()
+{
+  s_chip.flush();
+  return true;
+}
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// pca9685Leds class drives RGB LEDs from a PCA9685 PWM chip.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+#include "pca9685.h"
+
+//
+// LED hardware for ledSequence (see ledsequence.h).  Each LED takes 3 channels of the chip 
+// (red, green then blue) so it can drive 5 of them.  setPixel() only changes the chip's 
+// register copy and flush() sends all of the changes in one go.
+//
+
+class pca9685Leds
+{
+  public:
+    static const uint8_t numPixels = 5;
+
+  private:
+    static const uint8_t chipAddress = 0x41;
+    static const uint16_t pwmHz = 1000;
+
+  // Methods
+  public:
+    static void setup();
+    static uint32_t getPixel(uint8_t pixel) { return s_color[pixel]; }
+    static void setPixel(uint8_t pixel, uint32_t color);
+    static bool flush();
+    static uint32_t getBytesSent() { return s_chip.getBytesSent(); }
+
+  // Attributes
+  private:
+    static pca9685 s_chip;
+    static uint32_t s_color[numPixels];
+};
@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the profiler class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "profiler.h"
+
+#ifdef PROFILE
+
+#include "trace.h"
+
+profiler::slotStats profiler::s_stats[numSlots];
+uint16_t profiler::s_skipped = 0;
+uint8_t profiler::s_dumpRow = 0;
+
+void profiler::setup()
+{
+  // Start Timer1 counting at 0.5us if the Servo library isn't running it
+  if ((TCCR1B & (bit(CS12) | bit(CS11) | bit(CS10))) == 0)
+  {
+    TCCR1A = 0;
+    TCCR1B = bit(CS11);
+  }
+}
+
+//
+// now
+//
+// Reads TCNT1.  The two halves go through a register that an interrupt handler reading 
+// Timer1 (ledPwm, toneSynth) would change in between, so they are read with interrupts off.
+//
+
+uint16_t profiler::now()
+{
+  noInterrupts();
+  uint16_t count = TCNT1;
+  interrupts();
+  return count;
+}
+
+void profiler::record(uint8_t slot, uint16_t startCount)
+{
+  uint16_t endCount = now();
+  slotStats& stats = s_stats[slot];
+
+  // The Servo library started a new frame part way through
+  if (endCount < startCount)
+  {
+    if (s_skipped < 0xFFFF) s_skipped++;
+    return;
+  }
+
+  // Stop counting rather than let the calls wrap and spoil the average
+  if (stats.calls == 0xFFFF) return;
+
+  uint16_t counts = endCount - startCount;
+  stats.calls++;
+  stats.totalCounts += counts;
+  if (counts > stats.maxCounts) stats.maxCounts = counts;
+}
+
+//
+// command
+//
+// Acts on a byte received on the serial port: 'p' logs the measurements, 'c' clears them
+//
+
+void profiler::command(int command)
+{
+  if (command == 'p')
+  {
+    s_dumpRow = 1;
+  }
+  else if (command == 'c')
+  {
+    memset(s_stats, 0, sizeof(s_stats));
+    s_skipped = 0;
+  }
+}
+
+//
+// service
+//
+// Logs as many of the requested rows as there is room for in the trace buffer, one for each
+// opcode and section that has been called.  Call from loop().
+//
+
+void profiler::service()
+{
+  // Bytes in a logged row: ID, opcode or section, stats
+  const uint8_t rowBytes = 2 + sizeof(slotStats);
+
+  while (s_dumpRow != 0 && trace::hasRoom(rowBytes))
+  {
+    uint8_t slot = s_dumpRow - 1;
+
+    if (slot == numSlots)
+    {
+      // Finish with how many measurements were skipped
+      trace::log(TR_PROFILE_SKIPPED, reinterpret_cast<const uint8_t*> (&s_skipped), sizeof(s_skipped));
+      s_dumpRow = 0;
+      break;
+    }
+
+    if (s_stats[slot].calls != 0)
+    {
+      const uint8_t* pStats = reinterpret_cast<const uint8_t*> (&s_stats[slot]);
+      if (slot < numActions) trace::log(TR_PROFILE_ACTION, slot, pStats, sizeof(slotStats));
+      else trace::log(TR_PROFILE_SECTION, uint8_t(slot - numActions), pStats, sizeof(slotStats));
+    }
+    s_dumpRow++;
+  }
+}
+
+#endif
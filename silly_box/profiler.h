@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// profiler class measures how long the sequence engine spends in each action and in each 
+// of its main functions.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+#include "action.h"
+
+// Define PROFILE to measure.  Otherwise ProfileAction() and ProfileSection() compile to 
+// nothing and the profiler takes no RAM or time at all.
+
+//#define PROFILE
+
+// The functions measured by ProfileSection().  The times include whatever they call, so
+// PROF_GROUP_LOOP includes PROF_PROCESS_SEQUENCE which includes the rest.
+enum profileSection : uint8_t
+{
+  PROF_GROUP_LOOP,          // group::loop()
+  PROF_PROCESS_SEQUENCE,    // sequence::processSequence()
+  PROF_MOVE_PREPARE,        // moveSequence::prepareAction()
+  PROF_MOVE_EXECUTE,        // moveSequence::executeAction()
+  PROF_LED_PREPARE,         // ledSequence::prepareAction()
+  PROF_LED_EXECUTE,         // ledSequence::executeAction()
+  PROF_LED_TRANSITION,      // ledSequence::transitionLed()
+  PROF_SOUND_PREPARE,       // soundSequence::prepareAction()
+  PROF_SOUND_EXECUTE,       // soundSequence::executeAction()
+  NUM_PROFILE_SECTIONS
+};
+
+// Put one of these at the top of a block to measure the rest of the block.  ProfileAction() 
+// counts against the action's opcode.
+#ifdef PROFILE
+  #define ProfileAction(_ACTION)    profiler::scope profileScope(_ACTION)
+  #define ProfileSection(_SECTION)  profiler::scope profileScope(profiler::numActions + (_SECTION))
+#else
+  #define ProfileAction(_ACTION)
+  #define ProfileSection(_SECTION)
+#endif
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! Times are read from Timer1 like ledPwm and toneSynth measure their interrupts: 0.5us   !!
+// !! (8 cycles) per count with the Servo library.  With SERVO_PCA9685 nothing runs Timer1   !!
+// !! so setup() starts it at the same rate.  The Servo library sets TCNT1 back to 0 at the  !!
+// !! start of each 20ms frame; a measurement that spans that can't be worked out and is     !!
+// !! counted as skipped instead.  So nothing over 32ms can be measured, and the longest     !!
+// !! calls are a little less likely to be seen.  Interrupts that come in during a call are  !!
+// !! counted in its time.                                                                   !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+//
+// Each action opcode and each section keeps its number of calls, total time and longest
+// time.  Sending 'p' on the serial port logs them (TR_PROFILE_XXX, see 
+// tools/trace_decode.py which prints the average and longest in cycles) and 'c' clears them.
+//
+
+class profiler
+{
+  public:
+    static const uint8_t numActions = ACTION_END + 1;
+    static const uint8_t cyclesPerCount = 8;
+
+  // Methods.  They do nothing unless PROFILE is defined.
+  public:
+#ifdef PROFILE
+    static void setup();
+    static void command(int command);
+    static void service();
+
+    struct scope
+    {
+      scope(uint8_t slot) : m_slot(slot), m_startCount(now()) {}
+      ~scope() { record(m_slot, m_startCount); }
+      uint8_t m_slot;
+      uint16_t m_startCount;
+    };
+#else
+    static void setup() {}
+    static void command(int) {}
+    static void service() {}
+#endif
+
+#ifdef PROFILE
+  private:
+    static uint16_t now();
+    static void record(uint8_t slot, uint16_t startCount);
+
+  // Attributes
+  private:
+    static const uint8_t numSlots = numActions + NUM_PROFILE_SECTIONS;
+
+    struct slotStats        // logged as is, so keep it in step with {prof} in trace_decode.py
+    {
+      uint32_t totalCounts;
+      uint16_t calls;
+      uint16_t maxCounts;
+    };
+    static slotStats s_stats[numSlots];
+    static uint16_t s_skipped;    // measurements that spanned a Timer1 reset
+    static uint8_t s_dumpRow;     // next slot to log plus 1, or 0 when not logging them
+#endif
+};
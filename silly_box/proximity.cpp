@@ -24,18 +24,32 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
 
-#define DEBUG
+#define TRACE
 
 #include "proximity.h"
+#include "scheduler.h"
 
 proximitySensor proxSensor;
 const float proximitySensor::maxProximityCm = 15; // cm
 
+volatile uint8_t* proximitySensor::s_pEchoPort;
+uint8_t proximitySensor::s_echoMask;
+volatile proximitySensor::echoState proximitySensor::s_echoState = ECHO_IDLE;
+volatile uint32_t proximitySensor::s_echoStartUs;
+volatile uint32_t proximitySensor::s_echoWidthUs;
+volatile bool proximitySensor::s_echoReady = false;
+
+// The echo pin (9) is on port B so its pin change interrupt is PCINT0
+ISR(PCINT0_vect)
+{
+  proximitySensor::echoChange();
+}
+
 proximitySensor::proximitySensor()
 {
+  m_prevScanMs = 0;
 }
 
 proximitySensor::~proximitySensor()
@@ -45,41 +59,67 @@ proximitySensor::~proximitySensor()
 void proximitySensor::setup()
 {
   // Trigger and echo pins.  HC-SR04 uses a separate pin for each.
-  // Parallax Ping uses the same pin for trigger and echo.
   pinMode(trigPin, OUTPUT);
-  #if (trigPin != echoPin)
+  digitalWrite(trigPin, LOW);
   pinMode(echoPin, INPUT);
-  #endif
+
+  // The echo pulse is timed by the pin change interrupt rather than pulseIn() so that
+  // loop() never waits on the sensor.
+  s_pEchoPort = portInputRegister(digitalPinToPort(echoPin));
+  s_echoMask = digitalPinToBitMask(echoPin);
+  *digitalPinToPCMSK(echoPin) |= bit(digitalPinToPCMSKbit(echoPin));
+  PCIFR = bit(digitalPinToPCICRbit(echoPin));
+  *digitalPinToPCICR(echoPin) |= bit(digitalPinToPCICRbit(echoPin));
 }
 
+//
+// echoChange
+//
+// Called from the pin change interrupt.  Timestamps the rising edge of the echo pulse and 
+// on the falling edge hands the pulse width to getDistanceCm().  Edges that arrive when no
+// ping is outstanding are ignored.
+//
+
+void proximitySensor::echoChange()
+{
+  uint32_t nowUs = micros();
+  bool echoHigh = (*s_pEchoPort & s_echoMask) != 0;
+
+  if (s_echoState == ECHO_WAIT_RISE && echoHigh)
+  {
+    s_echoStartUs = nowUs;
+    s_echoState = ECHO_WAIT_FALL;
+  }
+  else if (s_echoState == ECHO_WAIT_FALL && !echoHigh)
+  {
+    s_echoWidthUs = nowUs - s_echoStartUs;
+    s_echoReady = true;
+    s_echoState = ECHO_IDLE;
+    scheduler::wake();
+  }
+}
+
+//
+// getDistanceCm
+//
+// Picks up the result of the last ping (if one has arrived) and starts a new ping every 
+// proximityScanMs.  Never waits for the echo.  A ping that hasn't echoed by the time the 
+// next one is due is abandoned and the last good distance is kept.
+//
+
 float proximitySensor::getDistanceCm()
 {     
   static float measuredDistanceCm = 0;
   static float lastDistanceCm = 400;
-  static uint32_t proxPrevMs = 0;
   uint32_t currentMs = millis();
 
-  if ((currentMs - proxPrevMs) >= proximityScanMs)
+  if (s_echoReady)
   {
-    proxPrevMs = currentMs;
-    
-    // Emit sound waves
-    digitalWrite(trigPin, LOW);
-    delayMicroseconds(5);
-    digitalWrite(trigPin, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(trigPin,LOW);
-    
-    // Measure echo
-    #if (trigPin == echoPin)
-      // Parallax Ping
-      pinMode(echoPin, INPUT);
-      unsigned long duration = pulseIn(echoPin, HIGH);
-      pinMode(trigPin, OUTPUT);
-    #else
-      // 
-      unsigned long duration = pulseIn(echoPin, HIGH);
-    #endif
+    uint32_t duration;
+    noInterrupts();
+    duration = s_echoWidthUs;
+    s_echoReady = false;
+    interrupts();
 
     // Calculate distance
     measuredDistanceCm = duration*.034483/2;
@@ -94,9 +134,33 @@ float proximitySensor::getDistanceCm()
     // Save last distance measured
     lastDistanceCm = measuredDistanceCm;
   }
+
+  if ((currentMs - m_prevScanMs) >= proximityScanMs)
+  {
+    m_prevScanMs = currentMs;
+    
+    // Emit sound waves
+    digitalWrite(trigPin, LOW);
+    delayMicroseconds(5);
+    digitalWrite(trigPin, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(trigPin,LOW);
+
+    // Arm the echo measurement
+    s_echoState = ECHO_WAIT_RISE;
+  }
   return measuredDistanceCm;
 }
 
+//
+// Returns the millis() value at which the next scan is due
+//
+
+uint32_t proximitySensor::getNextDeadline()
+{
+  return m_prevScanMs + proximityScanMs;
+}
+
 //
 // Read ultrasonic sensor and issue proximity alert if necessary
 //
@@ -120,11 +184,11 @@ bool proximitySensor::proximityAlertCheck()
     // triggers.
     if (!lastDetected && currentDetected)
     {
-      DebugPrintln(F("Approaching switch..."));
+      Trace(TR_APPROACHING);
       // Just for fun we will ignore approaches 50% of the time.  We want to give the humans a chance!
       alert = static_cast<bool>(random(2));
-      if (alert) DebugPrintln(F("--- issung proximity alert ---"));
-      else DebugPrintln(F("ignoring approach"));
+      if (alert) Trace(TR_PROX_ALERT);
+      else Trace(TR_PROX_IGNORED);
     }
     lastDetected = currentDetected;
   }
@@ -26,7 +26,7 @@
 
 #pragma once
 #include "Arduino.h"
-#include "debug.h"
+#include "trace.h"
 
 class proximitySensor
 {
@@ -36,13 +36,35 @@ class proximitySensor
     static const float maxProximityCm;
     static const uint32_t proximityScanMs = 100;
 
+    // Echo measurement states
+    enum echoState
+    {
+      ECHO_IDLE,
+      ECHO_WAIT_RISE,
+      ECHO_WAIT_FALL
+    };
+
   // Methods
   public:
     proximitySensor();    
     ~proximitySensor();    
     float getDistanceCm();
     bool proximityAlertCheck();
+    uint32_t getNextDeadline();
     static void setup();
+    static void echoChange();
+
+  // Attributes
+  private:
+    uint32_t m_prevScanMs;
+
+    // Echo measurement, shared with the pin change interrupt
+    static volatile uint8_t* s_pEchoPort;
+    static uint8_t s_echoMask;
+    static volatile echoState s_echoState;
+    static volatile uint32_t s_echoStartUs;
+    static volatile uint32_t s_echoWidthUs;
+    static volatile bool s_echoReady;
 };
 
 extern proximitySensor proxSensor;
@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the reactionTimer class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reactiontimer.h"
+
+#ifdef REACTION_TIMER
+
+#include "trace.h"
+
+reactionTimer::stageType reactionTimer::s_stage = WAITING_FOR_SWITCH;
+uint8_t reactionTimer::s_group;
+uint32_t reactionTimer::s_edgeUs;
+uint8_t reactionTimer::s_dumpRow = 0;
+uint8_t reactionTimer::s_start[numBuckets];
+uint8_t reactionTimer::s_servo[maxGroups][numBuckets];
+uint8_t reactionTimer::s_strike[maxGroups][numBuckets];
+
+// Bytes in a logged histogram row: ID, group, buckets
+static const uint8_t rowBytes = 2 + reactionTimer::numBuckets;
+
+void reactionTimer::switchOn(uint32_t edgeUs)
+{
+  s_edgeUs = edgeUs;
+  s_stage = WAITING_FOR_GROUP;
+}
+
+void reactionTimer::groupStart(uint8_t group)
+{
+  if (s_stage != WAITING_FOR_GROUP) return;
+  if (group >= maxGroups)
+  {
+    s_stage = WAITING_FOR_SWITCH;
+    return;
+  }
+  s_group = group;
+  record(s_start);
+}
+
+//
+// record
+//
+// Counts the time since the switch edge in the histogram for this stage and moves on to
+// the next stage.
+//
+
+void reactionTimer::record(uint8_t* pHistogram)
+{
+  uint32_t ms = (micros() - s_edgeUs) / 1000;
+  uint8_t bucket = 0;
+
+  while (ms != 0 && bucket < numBuckets - 1)
+  {
+    ms >>= 1;
+    bucket++;
+  }
+  if (pHistogram[bucket] < 255) pHistogram[bucket]++;
+
+  if (s_stage == WAITING_FOR_STRIKE) s_stage = WAITING_FOR_SWITCH;
+  else s_stage = static_cast<stageType> (s_stage + 1);
+}
+
+//
+// command
+//
+// Acts on a byte received on the serial port: 'r' logs the histograms, 'c' clears them
+//
+
+void reactionTimer::command(int command)
+{
+  if (command == 'r')
+  {
+    s_dumpRow = 1;
+  }
+  else if (command == 'c')
+  {
+    memset(s_start, 0, sizeof(s_start));
+    memset(s_servo, 0, sizeof(s_servo));
+    memset(s_strike, 0, sizeof(s_strike));
+  }
+}
+
+//
+// service
+//
+// Logs as many of the requested histograms as there is room for in the trace buffer, so
+// none of them are lost and nothing waits.  Call from loop().
+//
+
+void reactionTimer::service()
+{
+  while (s_dumpRow != 0 && trace::hasRoom(rowBytes))
+  {
+    // Row 1 is the group start, then the servo and strike histograms of each group
+    uint8_t row = s_dumpRow - 1;
+    uint8_t group = (row - 1) >> 1;
+
+    if (row == 0) trace::log(TR_REACTION_START, s_start, numBuckets);
+    else if (row & 1) trace::log(TR_REACTION_SERVO, group, s_servo[group], numBuckets);
+    else trace::log(TR_REACTION_STRIKE, group, s_strike[group], numBuckets);
+
+    s_dumpRow++;
+    if (s_dumpRow > 1 + 2*maxGroups) s_dumpRow = 0;
+  }
+}
+
+#endif
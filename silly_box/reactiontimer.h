@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// reactionTimer class measures how long the box takes to react to the front switch and 
+// keeps the results as histograms.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+// Define REACTION_TIMER to measure the reaction times.  The histograms take 
+// 16*(1 + 2*maxGroups) bytes of RAM (496) so it is off unless it is being looked at.
+
+//#define REACTION_TIMER
+
+//
+// Each time the switch is turned on the time from the switch edge (switchEdgeUs in 
+// silly_box.ino) is taken to:
+//
+//   - the start of the switch group (SILLY_START_SWITCH_GROUP)
+//   - the group's first servo write
+//   - the strike (moveSequence::attemptSwitchOff()).  For moves the sketch paces (profiled
+//     moves, EXTEND_ARM_FROM_RETRACTED) that is when the arm reaches the switch.  EXTEND_ARM
+//     sends the servo straight to the switch, so for it that is when the strike is 
+//     commanded and the arm gets there some hundreds of ms later.
+//
+// and counted in a histogram for that stage, per group for the last two.  The histograms
+// have a bucket per power of 2 ms: bucket 0 is under 1ms, bucket n is 2^(n-1) to 2^n ms
+// and the last bucket also holds anything longer.  Counts stop at 255.  A measurement ends 
+// at the strike, when the group ends or when the switch is turned on again.  Only a group's
+// first strike counts, so each group's strike histogram is of one kind of move.
+//
+// Sending 'r' on the serial port logs the histograms (TR_REACTION_XXX, see 
+// tools/trace_decode.py which prints them with their percentiles) and 'c' clears them.
+//
+
+class reactionTimer
+{
+  public:
+    static const uint8_t numBuckets = 16;
+    // Switch groups measured.  MUST be the number of groups in switchGroupTable (tables.cpp
+    // checks it).
+    static const uint8_t maxGroups = 15;
+
+  // Methods.  They do nothing unless REACTION_TIMER is defined.
+  public:
+#ifdef REACTION_TIMER
+    static void switchOn(uint32_t edgeUs);
+    static void groupStart(uint8_t group);
+    static void servoWrite() { if (s_stage == WAITING_FOR_SERVO) record(s_servo[s_group]); }
+    static void strike() { if (s_stage == WAITING_FOR_STRIKE) record(s_strike[s_group]); }
+    static void groupEnd() { s_stage = WAITING_FOR_SWITCH; }
+    static void command(int command);
+    static void service();
+#else
+    static void switchOn(uint32_t) {}
+    static void groupStart(uint8_t) {}
+    static void servoWrite() {}
+    static void strike() {}
+    static void groupEnd() {}
+    static void command(int) {}
+    static void service() {}
+#endif
+
+#ifdef REACTION_TIMER
+  private:
+    static void record(uint8_t* pHistogram);
+
+  // Attributes
+  private:
+    enum stageType : uint8_t
+    {
+      WAITING_FOR_SWITCH,
+      WAITING_FOR_GROUP,
+      WAITING_FOR_SERVO,
+      WAITING_FOR_STRIKE
+    };
+    static stageType s_stage;
+    static uint8_t s_group;
+    static uint32_t s_edgeUs;
+    static uint8_t s_dumpRow;       // next histogram to log, or 0 when not logging them
+
+    static uint8_t s_start[numBuckets];
+    static uint8_t s_servo[maxGroups][numBuckets];
+    static uint8_t s_strike[maxGroups][numBuckets];
+#endif
+};
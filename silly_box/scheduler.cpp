@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the scheduler class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! Why IDLE sleep and not POWER-SAVE?                                                     !!
+// !!                                                                                        !!
+// !! millis() is driven by Timer0 and the servo pulses by Timer1.  Both are clocked from    !!
+// !! the I/O clock which only keeps running in IDLE.  POWER-SAVE would need Timer2 running  !!
+// !! from a 32kHz watch crystal which the Nano doesn't have.  In IDLE the CPU core is       !!
+// !! stopped and the Timer0 overflow wakes it about once a millisecond; sleepUntil() goes   !!
+// !! straight back to sleep until the deadline arrives.                                    !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#include "scheduler.h"
+#include <avr/sleep.h>
+
+uint32_t scheduler::s_asleepUs = 0;
+uint32_t scheduler::s_windowStartUs = 0;
+volatile bool scheduler::s_wakeRequested = false;
+
+void scheduler::setup()
+{
+  s_windowStartUs = micros();
+}
+
+//
+// sleepUntil
+//
+// Idles the processor until 'deadlineMs' (a millis() value) or until wake() is called,
+// whichever comes first.  Returns right away if the deadline has already passed or if wake()
+// was called since the last sleep (so nothing that happened while loop() was busy is missed).
+//
+
+void scheduler::sleepUntil(uint32_t deadlineMs)
+{
+  uint32_t startUs = micros();
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (!s_wakeRequested && static_cast<int32_t> (deadlineMs - millis()) > 0)
+  {
+    // A wake interrupt between the check above and noInterrupts() would be slept through, so
+    // look again with interrupts off.  From here on it can't slip in before the sleep: the
+    // instruction following sei() is always executed before any pending interrupt.
+    noInterrupts();
+    if (s_wakeRequested)
+    {
+      interrupts();
+      break;
+    }
+    sleep_enable();
+    interrupts();
+    sleep_cpu();
+    sleep_disable();
+  }
+  s_wakeRequested = false;
+
+  s_asleepUs += micros() - startUs;
+}
+
+//
+// getDutyCyclePermille
+//
+// Returns the time spent awake, in parts per thousand, since the last call and starts a new 
+// measurement window.
+//
+
+uint16_t scheduler::getDutyCyclePermille()
+{
+  uint32_t nowUs = micros();
+  uint32_t windowUs = nowUs - s_windowStartUs;
+  uint16_t permille = 1000;
+
+  if (windowUs > 0)
+  {
+    // Scale both down to keep the multiply from overflowing on long windows
+    permille = 1000 - static_cast<uint16_t> (((s_asleepUs >> 8) * 1000) / ((windowUs >> 8) + 1));
+  }
+  s_asleepUs = 0;
+  s_windowStartUs = nowUs;
+  return permille;
+}
+
+//
+// earliest
+//
+// Returns whichever of two millis() deadlines comes first, allowing for millis() rollover.
+//
+
+uint32_t scheduler::earliest(uint32_t deadlineA, uint32_t deadlineB)
+{
+  return (static_cast<int32_t> (deadlineA - deadlineB) < 0) ? deadlineA : deadlineB;
+}
@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// scheduler class puts the processor to sleep between deadlines in order to save battery.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// Nothing in this application needs the processor between deadlines (the next proximity 
+// scan, the idle timeout, the next action of the executing group) except a change on the 
+// front switch.  loop() works out the earliest deadline and calls sleepUntil() which idles
+// the processor until then or until an interrupt handler calls wake() (the front switch 
+// and the proximity echo both do).
+//
+
+class scheduler
+{
+  // Methods
+  public:
+    static void setup();
+    static void sleepUntil(uint32_t deadlineMs);
+    static uint16_t getDutyCyclePermille();
+    static uint32_t earliest(uint32_t deadlineA, uint32_t deadlineB);
+
+    // Ends the current sleepUntil() early.  Called from interrupt handlers that have 
+    // something for loop() to pick up.
+    static void wake() { s_wakeRequested = true; }
+
+  // Attributes
+  private:
+    static volatile bool s_wakeRequested;
+    static uint32_t s_asleepUs;       // time spent asleep in the current measurement window
+    static uint32_t s_windowStartUs;  // start of the current measurement window
+};
@@ -29,7 +29,64 @@
 // !! due to the limitations on how that memory is accessed.                     !!
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
+
+#define TRACE
+
 #include "sequence.h"
+#include "profiler.h"
+#include "trace.h"
+
+//
+// Operand layout for each action.  This table MUST be kept in the same order as the 
+// actionType enum in action.h.
+//
+
+const uint8_t sequence::actionFormat[] PROGMEM =
+{
+  // Generic Actions
+  ACTION_FORMAT(OPND_16,   OPND_NONE, OPND_NONE),   // ACTION_DELAY
+
+  // Flow Control Actions
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_LOOP
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_NEXT
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_CALL
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_RET
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_JUMP
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_NONE),   // ACTION_BRANCH_RANDOM
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_LAST_GENERIC
+
+  // Move Actions
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_OPEN_LID
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_CLOSE_LID
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_8),      // ACTION_MOVE_LID
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_NONE),   // ACTION_PEEK_LID_FROM_CLOSE
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_NONE),   // ACTION_CLOSE_LID_FROM_PEEK
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_OPEN_LID_FROM_CLOSE
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_CLOSE_LID_FROM_OPEN
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_EXTEND_ARM
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE),   // ACTION_RETRACT_ARM
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_8),      // ACTION_MOVE_ARM
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_EXTEND_ARM_FROM_RETRACTED
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_RETRACT_ARM_FROM_EXTENDED
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_8),      // ACTION_PROFILE_LID
+  ACTION_FORMAT(OPND_8,    OPND_8,    OPND_8),      // ACTION_PROFILE_ARM
+  ACTION_FORMAT(OPND_16,   OPND_16,   OPND_16),     // ACTION_PROFILE_LID_ARM
+  ACTION_FORMAT(OPND_16,   OPND_16,   OPND_16),     // ACTION_PROFILE_ARM_LID
+
+  // LED Actions
+  ACTION_FORMAT(OPND_16,   OPND_24,   OPND_NONE),   // ACTION_SET_LED
+  ACTION_FORMAT(OPND_16,   OPND_24,   OPND_16),     // ACTION_TRANS_LED
+
+  // Sound Actions
+  ACTION_FORMAT(OPND_8,    OPND_16,   OPND_16),     // ACTION_NOTE
+  ACTION_FORMAT(OPND_8,    OPND_NONE, OPND_NONE),   // ACTION_PLAY_SAMPLE
+
+  ACTION_FORMAT(OPND_NONE, OPND_NONE, OPND_NONE)    // ACTION_END
+};
+
+sequence::vmStack sequence::s_vmStacks[maxGroupSequences];
 
 sequence::sequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd)
 {
@@ -37,10 +94,12 @@ sequence::sequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd)
   m_seqType = aSeqType;
   if (m_seqType == PRIMARY_SEQ) m_seqEnd = ONE_SHOT;
   else m_seqEnd = aSeqEnd;
-  m_pSeqEntry = m_pSeqTable;
-  memcpy_P(&m_seqEntry, m_pSeqEntry, sizeof(seqEntry));
-  m_prevMillis = millis();
+  m_vmSlot = 0;
+  s_vmStacks[m_vmSlot].depth = 0;
+  m_pNextEntry = m_pSeqTable;
   m_seqState = SEQ_EXECUTING;
+  fetchAction();
+  m_deadlineMs = millis();
 }
 
 sequence::~sequence()
@@ -67,12 +126,30 @@ bool sequence::getSwitchOffAttempted()
   return m_switchOffAttempted;     
 }
 
+//
+// setVmSlot
+//
+// Selects which of the shared flow control stacks this sequence uses.  The group assigns
+// each of its sequences a different slot before starting them (the group constructor checks
+// that it has no more than maxGroupSequences of them).
+//
+
+void sequence::setVmSlot(uint8_t slot)
+{
+  m_vmSlot = slot;
+}
+
 //
 // processSequence
 //
 // This function is responsible for processing actions and determining if the current sequence is complete.  If 
 // the sequence is complete the SEQ_COMPLETE value is returned, otherwise SEQ_EXECUTING is returned.
 //
+// Timing is against absolute deadlines.  An action starts at the deadline the previous one finished on (not
+// at whatever millis() happened to be when we noticed) and each timed step moves the deadline on by its 
+// period, so loop latency never accumulates over a sequence.  When the next action is already due as the 
+// current one completes it is executed in the same call rather than on the next pass through loop().
+//
 // While sequences are being processed this method should be called every time the loop() function is executed.
 //  
 
@@ -81,16 +158,24 @@ sequence::seqState sequence::processSequence()
   // NOTE:  If this is a ONE_SHOT sequence and all of the actions are completed then
   // prepareAction() will return a SEQ_COMPLETE.  Once this happens all calls to 
   // processAction() will return a SEQ_COMPLETE.
+  ProfileSection(PROF_PROCESS_SEQUENCE);
   
-  // Execute the action
-  actionState actState = executeAction();
-
-  // If the action is complete move to the next action and check for the end of the
-  // sequence.
-  if (m_seqState == SEQ_EXECUTING && actState == ACTION_COMPLETE)
+  for (uint8_t chained = 0; chained < maxChainedActions; chained++)
   {
-    m_pSeqEntry += sizeof(seqEntry);
-    memcpy_P(&m_seqEntry, m_pSeqEntry, sizeof(seqEntry));
+    // Execute the action
+    actionState actState;
+    {
+      ProfileAction(m_seqEntry.action);
+      actState = executeAction();
+    }
+
+    // If the action is still going (or the sequence has been stopped) there is nothing more to do
+    if (m_seqState != SEQ_EXECUTING || actState != ACTION_COMPLETE) break;
+
+    // The action is complete so move to the next action and check for the end of the
+    // sequence.
+    fetchAction();
+    if (m_seqState != SEQ_EXECUTING) return m_seqState;
     if (m_seqEntry.action == ACTION_END) 
     {
       // At the end of the sequence table
@@ -103,24 +188,40 @@ sequence::seqState sequence::processSequence()
       else // m_seqEnd == REPEATING
       {
         // Repeat sequence
-        m_pSeqEntry = m_pSeqTable;
-        memcpy_P(&m_seqEntry, m_pSeqEntry, sizeof(seqEntry));
+        s_vmStacks[m_vmSlot].depth = 0;
+        m_pNextEntry = m_pSeqTable;
+        fetchAction();
+        if (m_seqState != SEQ_EXECUTING) return m_seqState;
       }
     }
-    m_prevMillis = millis();
-    prepareAction();
+    {
+      ProfileAction(m_seqEntry.action);
+      prepareAction();
+    }
+
+    // Carry straight on if the new action is already due
+    if (!deadlineReached()) break;
   }
   return m_seqState;
 }
 
-void sequence::startSequence()
+//
+// startSequence
+//
+// Starts the sequence from the top of its table.  'startMs' is the millis() value the first action 
+// is timed from; a group passes the same value to all of its sequences so they stay in step.
+//
+
+void sequence::startSequence(uint32_t startMs)
 {
-  m_pSeqEntry = m_pSeqTable;
-  memcpy_P(&m_seqEntry, m_pSeqEntry, sizeof(seqEntry));
-  m_prevMillis = millis();
-  prepareAction();
+  s_vmStacks[m_vmSlot].depth = 0;
+  m_pNextEntry = m_pSeqTable;
   m_seqState = SEQ_EXECUTING;
   m_switchOffAttempted = false;
+  fetchAction();
+  if (m_seqState != SEQ_EXECUTING) return;
+  m_deadlineMs = startMs;
+  prepareAction();
 }
 
 void sequence::stopSequence()
@@ -128,19 +229,270 @@ void sequence::stopSequence()
   m_seqState = SEQ_COMPLETE;
 }
 
+//
+// getNextDeadline
+//
+// Returns the millis() value at which processSequence() next has something to do for the 
+// current action.  Calling processSequence() earlier than this is harmless, it just finds 
+// nothing to do.
+//
+
+uint32_t sequence::getNextDeadline()
+{
+  return m_deadlineMs;
+}
+
+//
+// deadlineReached
+//
+// True once millis() has reached m_deadlineMs (rollover safe)
+//
+
+bool sequence::deadlineReached()
+{
+  return static_cast<int32_t> (millis() - m_deadlineMs) >= 0;
+}
+
+//
+// advanceDeadline
+//
+// Moves the deadline on by one period from where it was, not from now, so a late step is followed by
+// a short one and the steps average out to exactly 'periodMs'.  If we have fallen more than a whole 
+// period behind (loop() was held up) the deadline is pulled up to now rather than firing a burst of 
+// catch-up steps.
+//
+
+void sequence::advanceDeadline(uint32_t periodMs)
+{
+  uint32_t now = millis();
+  m_deadlineMs += periodMs;
+  if (static_cast<int32_t> (now - m_deadlineMs) > static_cast<int32_t> (periodMs)) m_deadlineMs = now;
+}
+
 void sequence::prepareAction()
 {
-  if (m_seqEntry.action == ACTION_DELAY) m_prevMillis = millis();
+  // The delay ends data1 ms after the action started
+  if (m_seqEntry.action == ACTION_DELAY) m_deadlineMs += m_seqEntry.data1;
 }
 
 sequence::actionState sequence::executeAction()
 {
   if (m_seqEntry.action == ACTION_DELAY)
   {
-    if (millis() - m_prevMillis > m_seqEntry.data1) return ACTION_COMPLETE;
+    if (deadlineReached()) return ACTION_COMPLETE;
     else return ACTION_EXECUTING;
   }
   
   // If we got to here then we didn't recognize the action.
   return ACTION_COMPLETE;
 }
+
+//
+// fetchAction
+//
+// Decodes the next action to be executed into m_seqEntry.  Flow control actions are carried
+// out here as they are encountered so the derived classes only ever see actions that do
+// something.  A RET with nothing to return to ends the sequence, and so does a LOOP or CALL
+// with no room left on the stack (the tables are checked against vmStackDepth by the host
+// build's "tables" test, see getNestingDepth()), or more than maxFlowSteps flow control 
+// actions without one that does something.
+//
+
+void sequence::fetchAction()
+{
+  vmStack& stack = s_vmStacks[m_vmSlot];
+
+  for (uint8_t steps = 0; ; steps++)
+  {
+    if (steps > maxFlowSteps)
+    {
+      Trace(TR_VM_RUNAWAY, static_cast<uint8_t> (m_seqEntry.action));
+      m_seqEntry.action = ACTION_END;
+      m_seqState = SEQ_COMPLETE;
+      return;
+    }
+
+    loadAction();
+    switch (m_seqEntry.action)
+    {
+      case ACTION_LOOP:
+        if (!pushFrame(m_seqEntry.data1)) return;
+        break;
+
+      case ACTION_NEXT:
+        if (stack.depth > 0)
+        {
+          vmFrame& frame = stack.frames[stack.depth - 1];
+          if (frame.count == LOOP_FOREVER || --frame.count > 0)
+          {
+            // Go around again
+            m_pNextEntry = frame.pEntry;
+          }
+          else
+          {
+            // Loop is done
+            stack.depth--;
+          }
+        }
+        break;
+
+      case ACTION_BRANCH_RANDOM:
+        // data1 is the percent chance of calling subroutine data2
+        if (static_cast<uint32_t> (random(100)) >= m_seqEntry.data1) break;
+        if (!pushFrame(0)) return;
+        m_pNextEntry = getSubroutine(m_seqEntry.data2);
+        break;
+
+      case ACTION_CALL:
+        if (!pushFrame(0)) return;
+        m_pNextEntry = getSubroutine(m_seqEntry.data1);
+        break;
+
+      case ACTION_JUMP:
+        m_pNextEntry = getSubroutine(m_seqEntry.data1);
+        break;
+
+      case ACTION_RET:
+        if (stack.depth == 0)
+        {
+          m_seqEntry.action = ACTION_END;
+          return;
+        }
+        stack.depth--;
+        m_pNextEntry = stack.frames[stack.depth].pEntry;
+        break;
+
+      default:
+        // Not flow control so this is the next action to execute
+        return;
+    }
+  }
+}
+
+//
+// pushFrame
+//
+// Saves m_pNextEntry (the LOOP body or CALL return address) on the flow control stack.  If 
+// the stack is full the sequence is stopped rather than carrying on with the wrong actions.
+//
+
+bool sequence::pushFrame(uint8_t count)
+{
+  vmStack& stack = s_vmStacks[m_vmSlot];
+
+  if (stack.depth >= vmStackDepth)
+  {
+    Trace(TR_VM_OVERFLOW, static_cast<uint8_t> (m_seqEntry.action));
+    m_seqEntry.action = ACTION_END;
+    m_seqState = SEQ_COMPLETE;
+    return false;
+  }
+  stack.frames[stack.depth].pEntry = m_pNextEntry;
+  stack.frames[stack.depth].count = count;
+  stack.depth++;
+  return true;
+}
+
+const uint8_t* sequence::getSubroutine(uint32_t index)
+{
+  return static_cast<const uint8_t*> (pgm_read_ptr_near(&seqSubroutineTable[index]));
+}
+
+//
+// loadAction
+//
+// Decodes the action at m_pNextEntry into m_seqEntry and advances m_pNextEntry past it.  The
+// opcode selects the operand layout from actionFormat and each operand is read straight from
+// program memory, so only the bytes the action actually uses are touched.
+//
+
+void sequence::loadAction()
+{
+  static_assert(sizeof(actionFormat) == ACTION_END + 1, "actionFormat does not match actionType");
+
+  m_seqEntry.action = static_cast<actionType> (pgm_read_byte_near(m_pNextEntry++));
+  uint8_t format = pgm_read_byte_near(&actionFormat[m_seqEntry.action]);
+  m_seqEntry.data1 = readOperand(m_pNextEntry, format & 0x03);
+  m_seqEntry.data2 = readOperand(m_pNextEntry, (format >> 2) & 0x03);
+  m_seqEntry.data3 = readOperand(m_pNextEntry, (format >> 4) & 0x03);
+}
+
+uint32_t sequence::readOperand(const uint8_t*& pEntry, uint8_t width)
+{
+  uint32_t value = 0;
+  for (uint8_t shift = 0; width > 0; width--, shift += 8)
+  {
+    value |= static_cast<uint32_t> (pgm_read_byte_near(pEntry++)) << shift;
+  }
+  return value;
+}
+
+//
+// getNestingDepth
+//
+// The deepest the sequence table takes the flow control stack, counting every CALL and 
+// BRANCH_RANDOM as taken.  Anything over vmStackDepth would stop the sequence part way 
+// through, so the host build checks every group with this (host/tablecheck.cpp).
+//
+
+uint8_t sequence::getNestingDepth()
+{
+  return tableDepth(m_pSeqTable, 0, maxTableJumps);
+}
+
+//
+// tableDepth
+//
+// Walks the table at 'pEntry', which is entered 'depth' frames deep, and returns the deepest 
+// it goes.  Stops early once past vmStackDepth (so a subroutine that calls itself ends the 
+// walk) and after 'jumps' JUMPs (so a JUMP back to an earlier subroutine does).
+//
+
+uint8_t sequence::tableDepth(const uint8_t* pEntry, uint8_t depth, uint8_t jumps)
+{
+  uint8_t deepest = depth;
+
+  while (deepest <= vmStackDepth)
+  {
+    actionType action = static_cast<actionType> (pgm_read_byte_near(pEntry++));
+    uint8_t format = pgm_read_byte_near(&actionFormat[action]);
+    uint32_t data1 = readOperand(pEntry, format & 0x03);
+    uint32_t data2 = readOperand(pEntry, (format >> 2) & 0x03);
+    readOperand(pEntry, (format >> 4) & 0x03);
+
+    switch (action)
+    {
+      case ACTION_LOOP:
+        depth++;
+        break;
+
+      case ACTION_NEXT:
+        if (depth > 0) depth--;
+        break;
+
+      case ACTION_CALL:
+      case ACTION_BRANCH_RANDOM:
+      {
+        uint8_t sub = (action == ACTION_CALL) ? data1 : data2;
+        uint8_t called = tableDepth(getSubroutine(sub), depth + 1, jumps);
+        if (called > deepest) deepest = called;
+        break;
+      }
+
+      case ACTION_JUMP:
+        if (jumps == 0) return deepest;
+        jumps--;
+        pEntry = getSubroutine(data1);
+        break;
+
+      case ACTION_RET:
+      case ACTION_END:
+        return deepest;
+
+      default:
+        break;
+    }
+    if (depth > deepest) deepest = depth;
+  }
+  return deepest;
+}
@@ -28,7 +28,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 #pragma once
-#include "debug.h"
+#include "trace.h"
 #include "action.h"
 
 class sequence
@@ -61,6 +61,9 @@ class sequence
     };
 
     // Structures
+
+    // Decoded form of the current action.  Tables are stored in the compact byte encoding
+    // described in action.h; operands not present in the table are zero.
     struct seqEntry
     {
       actionType action;
@@ -69,6 +72,36 @@ class sequence
       uint32_t data3; // delay in ms
     };
 
+    // Flow control (LOOP/CALL) stack.  Only one group executes at a time so rather than 
+    // every sequence object carrying its own stack, the sequences of the executing group 
+    // share a small pool and each one uses the stack matching its position in the group.
+    static const uint8_t vmStackDepth = 3;
+    static const uint8_t maxGroupSequences = 4;
+
+    // Most actions processSequence() will carry out in one call when each one is already
+    // due as the previous one finishes (keeps a table of only immediate actions from
+    // hogging loop())
+    static const uint8_t maxChainedActions = 8;
+
+    // Most flow control actions fetchAction() will follow looking for the next action.  A
+    // LOOP with nothing in it or a JUMP back to itself would otherwise hang loop().
+    static const uint8_t maxFlowSteps = 32;
+
+    // JUMPs getNestingDepth() follows before giving up on a table that never ends
+    static const uint8_t maxTableJumps = 16;
+
+    struct vmFrame
+    {
+      const uint8_t* pEntry;  // LOOP body start or CALL return address
+      uint8_t count;          // LOOP iterations remaining (LOOP_FOREVER for no limit)
+    };
+
+    struct vmStack
+    {
+      uint8_t depth;
+      vmFrame frames[vmStackDepth];
+    };
+
   // Construction
   public:
   // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -86,17 +119,37 @@ class sequence
     seqEnd getSeqEnd();
     seqState getSeqState();
     bool getSwitchOffAttempted();
-    virtual void startSequence();
+    void setVmSlot(uint8_t);
+    uint8_t getNestingDepth();
+    uint32_t getNextDeadline();
+    virtual void startSequence(uint32_t startMs);
     virtual void stopSequence();
 
   protected:
     virtual void prepareAction();
     virtual actionState executeAction();
+    bool deadlineReached();
+    void advanceDeadline(uint32_t periodMs);
   
   private:
+    void fetchAction();
+    bool pushFrame(uint8_t count);
+    void loadAction();
+    static uint32_t readOperand(const uint8_t*& pEntry, uint8_t width);
+    static const uint8_t* getSubroutine(uint32_t);
+    static uint8_t tableDepth(const uint8_t* pEntry, uint8_t depth, uint8_t jumps);
+
+  private:
+    // Operand layout of each action, indexed by actionType
+    static const uint8_t actionFormat[] PROGMEM;
+
+    // Flow control stacks shared by the executing group
+    static vmStack s_vmStacks[maxGroupSequences];
+    uint8_t m_vmSlot;
+
     // Sequence Table Information
     const uint8_t* m_pSeqTable;
-    const uint8_t* m_pSeqEntry;
+    const uint8_t* m_pNextEntry; // next action to be decoded
     seqType m_seqType;     
     seqEnd m_seqEnd;
     seqState m_seqState;
@@ -104,6 +157,9 @@ class sequence
   protected:
     // Context for processing current action
     seqEntry m_seqEntry;
-    uint32_t m_prevMillis; // used for timing delays
+    uint32_t m_deadlineMs; // millis() at which the current action (or its next step) is due
     bool m_switchOffAttempted;
 };
+
+// Subroutine tables used by SEQ_CALL, SEQ_JUMP, and SEQ_BRANCH_RANDOM (defined in tables.cpp)
+extern const uint8_t* const seqSubroutineTable[] PROGMEM;
@@ -41,26 +41,37 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
 
-#define DEBUG
+#define TRACE
 
 #include "sequence.h"
 #include "movesequence.h"
 #include "ledsequence.h"
+#include "ledpwm.h"
 #include "soundsequence.h"
 #include "group.h"
-#include "debug.h"
+#include "scheduler.h"
+#include "reactiontimer.h"
+#include "profiler.h"
+#include "stackmonitor.h"
+#include "trace.h"
 
-// Front switch pin
+// Front switch pin.  Must be an external interrupt pin (2 or 3, but 3 is the speaker).
 const int switchPin = 2;
 
+// Front switch debounce.  A transition is reported as soon as the first edge is seen and
+// then the switch is left alone for this long while it settles.
+const unsigned long switchDebounceMs = 50;
+
 // Idle timer.  If there is no activity for the timeout period then
 // a sequence will be executed.  This is to remind the human to turn
 // the power switch off.
 const unsigned long idleTimeoutMs = 5 * 60 * 1000L; // 5 minutes
 
+// How often the awake duty cycle is reported (traced only)
+const unsigned long dutyCycleReportMs = 10 * 1000L;
+
 // Front switch action
 enum switchActionEnum
 {
@@ -89,17 +100,46 @@ extern const int numProxGroups;
 // Test mode group
 extern group testMode;
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Front switch edge capture
+//
+// The switch interrupt records the micros() time of the first edge since the last 
+// transition was reported.  That is as close as we can get to the moment a human (or the
+// arm) actually moved the switch.  'switchEdgeUs' holds the edge time behind the most
+// recent transition reported by switchActionCheck() so reaction latency can be measured 
+// from it.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+volatile unsigned long pendingSwitchEdgeUs;
+volatile bool switchEdgePending = false;
+unsigned long switchEdgeUs;
+
+// Debounce state
+bool switchSettling = false;
+unsigned long switchSettleStartMs;
+
+void switchEdgeIsr()
+{
+  if (!switchEdgePending)
+  {
+    pendingSwitchEdgeUs = micros();
+    switchEdgePending = true;
+  }
+  scheduler::wake();
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 //
 // switchActionCheck()
 //
 // Read the switch and determine if it has transitioned.  We don't really care about the
-// 'state' of the switch but only changes in state.  FYI, this is the only place you will 
-// find a delay() in this code.  Every other delay is timed using the millis() function.
-// The reason it is done here is because it is a quick and dirty way of ignoring switch
-// bounce.  Since the switch is transitioning anyway I don't worry with affecting the 
-// timing of the sequences since a transition usually means a sequence group is beginning
-// or ending.
+// 'state' of the switch but only changes in state.  A transition is reported right away 
+// and then the switch is ignored for switchDebounceMs so the bounce isn't seen as more 
+// transitions.  Nothing waits here; while the switch is settling this simply returns 
+// NO_CHANGE.  Once it has settled the pin is compared again in case it really did change 
+// back in the meantime.
 //
 // NOTE: This should be called every time loop() is executed
 //
@@ -113,12 +153,28 @@ extern group testMode;
 int switchActionCheck()
 {
   static byte lastSwitchState = digitalRead(switchPin);
-  byte currentSwitchState = digitalRead(switchPin);
   switchActionEnum switchAction = NO_CHANGE;
 
+  if (switchSettling)
+  {
+    if (millis() - switchSettleStartMs < switchDebounceMs) return NO_CHANGE;
+    switchSettling = false;
+  }
+
+  byte currentSwitchState = digitalRead(switchPin);
+  noInterrupts();
+  bool edgePending = switchEdgePending;
+  unsigned long edgeUs = pendingSwitchEdgeUs;
+  switchEdgePending = false;
+  interrupts();
+
   if (currentSwitchState != lastSwitchState)
   {
-    delay(50); // debounce
+    // If the change was seen by polling rather than the interrupt there is no better 
+    // timestamp than now
+    switchEdgeUs = edgePending ? edgeUs : micros();
+    switchSettling = true;
+    switchSettleStartMs = millis();
     lastSwitchState = currentSwitchState;
     if (currentSwitchState == LOW)
     {
@@ -144,11 +200,14 @@ int switchActionCheck()
 
 void setup()
 {
-  // Serial debug
-  DebugInit(115200);
+  // Trace log on the serial port
+  trace::setup();
   
-  // Switch pin input
+  // Switch pin input.  Edges are timestamped by the interrupt, which also wakes the
+  // processor.
   pinMode(switchPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(switchPin), switchEdgeIsr, CHANGE);
+  scheduler::setup();
 
   // Random number seeding
   randomSeed(analogRead(A0));
@@ -157,8 +216,10 @@ void setup()
   proximitySensor::setup(); // Proximity sensor initialization
   moveSequence::setup();    // Movement hardware (servo) initialization
   ledSequence::setup();     // LED hardware initialization
+  soundSequence::setup();   // Speaker (tone synthesizer) initialization
+  profiler::setup();        // Timer1 for the profiler, after the servos have it running
 
-  DebugPrintln(F("Setup Complete"));
+  Trace(TR_SETUP_COMPLETE);
   
   // 
   // Test mode can only be entered if the testModePin is grounded at power up.
@@ -166,12 +227,10 @@ void setup()
   pinMode(testModePin, INPUT_PULLUP);
   if (digitalRead(testModePin) == LOW) 
   {
-    DebugPrintln(F("********** ENTERING TEST MODE ************"));
+    Trace(TR_TEST_MODE);
     // Set servos to lid fully opened and arm fully extended.  This allows control horns on the
     // servos to be set to the proper angles.
-    moveSequence::lidServo.write(moveSequence::lidOpenedAngle);
-    delay(1000);
-    moveSequence::armServo.write(moveSequence::armExtendedAngle);
+    moveSequence::testPosition();
     while(1); // park here until reset
   }
 }
@@ -206,6 +265,9 @@ void loop()
   static int switchGroupIndex;  // currently processing switch group
   static int proxGroupIndex;    // currently processing prox group
   static unsigned long prevIdleMs = millis(); // idle timer milliseconds
+#ifdef TRACE
+  static unsigned long prevDutyCycleMs = millis(); // duty cycle report timer
+#endif
   
   ///////////////////////////////////////////////////////////////////////////////////////////
   // Process the current state of the silly box
@@ -214,6 +276,7 @@ void loop()
   // Get front switch action. Must be called every time through loop()!
   switchActionEnum switchAction = (switchActionEnum) switchActionCheck();
   unsigned long currMs = millis();
+  if (switchAction == TRANS_TO_ON) reactionTimer::switchOn(switchEdgeUs);
 
   switch (sillyState)
   {
@@ -235,8 +298,7 @@ void loop()
         // so begin the harassment procedure.
         prevIdleMs = currMs;
         proxGroupIndex = random(numProxGroups);
-        DebugPrint(F("Start Prox Group "));
-        DebugPrintln(proxGroupIndex);
+        Trace(TR_START_PROX_GROUP, static_cast<uint8_t> (proxGroupIndex));
         proxGroupTable[proxGroupIndex].start();
         sillyState = SILLY_EXEC_PROX_GROUP;
       }
@@ -246,10 +308,10 @@ void loop()
     // State SILLY_START_SWITCH_GROUP chooses a random switch group and starts it
     //
     case SILLY_START_SWITCH_GROUP:
-      DebugPrintln(F("SILLY_START_SWITCH_GROUP"));
+      Trace(TR_START_SWITCH_STATE);
       switchGroupIndex = random(numSwitchGroups);
-      DebugPrint(F("Start Switch Group "));
-      DebugPrintln(switchGroupIndex);
+      Trace(TR_START_SWITCH_GROUP, static_cast<uint8_t> (switchGroupIndex));
+      reactionTimer::groupStart(switchGroupIndex);
       switchGroupTable[switchGroupIndex].start();
       sillyState = SILLY_EXEC_SWITCH_GROUP;
       break;
@@ -265,7 +327,8 @@ void loop()
       if (switchAction == TRANS_TO_OFF && !switchGroupTable[switchGroupIndex].getSwitchOffAttempted()
       ||  switchGroupTable[switchGroupIndex].loop() == group::GROUP_COMPLETE)
       {
-        DebugPrintln(F("Switch Group Complete"));
+        Trace(TR_SWITCH_GROUP_COMPLETE);
+        reactionTimer::groupEnd();
         switchGroupTable[switchGroupIndex].reset();
         sillyState = SILLY_IDLE;
       } 
@@ -289,7 +352,7 @@ void loop()
       }
       else if (proxGroupTable[proxGroupIndex].loop() == group::GROUP_COMPLETE)
       {
-        DebugPrintln(F("Prox Group Complete"));
+        Trace(TR_PROX_GROUP_COMPLETE);
         proxGroupTable[proxGroupIndex].reset();
         sillyState = SILLY_IDLE;
       }
@@ -297,8 +360,82 @@ void loop()
 
     default:
       // !!!!!!!!!!!!!!!!!!!!!!  SHOULD NEVER HAPPEN  !!!!!!!!!!!!!!!!!!!!!!
-      DebugPrintln(F("ERROR: Invalid sillyState value!!! Resetting to idle state..."));
+      Trace(TR_BAD_STATE);
       sillyState = SILLY_IDLE;
       break;
   }
+
+  // Glide the servos home after a group was stopped. Must be called every time through loop()!
+  moveSequence::serviceHoming();
+  moveSequence::flush();
+
+  // Show this pass's LED changes. Must be called every time through loop()!
+  bool ledsShown = ledSequence::flush();
+
+#ifdef TRACE
+  if (currMs - prevDutyCycleMs >= dutyCycleReportMs)
+  {
+    prevDutyCycleMs = currMs;
+    Trace(TR_CPU_LOAD, scheduler::getDutyCyclePermille(), ledPwm::getCpuPermille(), toneSynth::getCpuPermille());
+    Trace(TR_STACK, stackMonitor::getVariableBytes(), stackMonitor::getUnusedBytes(), stackMonitor::getFreeBytes());
+  }
+#endif
+
+#if defined(REACTION_TIMER) || defined(PROFILE)
+  // Reaction time histograms and profile requested over the serial port
+  if (Serial.available() > 0)
+  {
+    int command = Serial.read();
+    reactionTimer::command(command);
+    profiler::command(command);
+  }
+#endif
+  reactionTimer::service();
+  profiler::service();
+
+  // Send what has been logged while there is nothing else to do
+  trace::drain();
+
+  ///////////////////////////////////////////////////////////////////////////////////////////
+  // Sleep until something needs doing.  A change on the front switch ends the sleep early.
+  ///////////////////////////////////////////////////////////////////////////////////////////
+
+  unsigned long nextMs;
+
+  switch (sillyState)
+  {
+    case SILLY_IDLE:
+      // Next proximity scan or the idle timeout
+      nextMs = scheduler::earliest(proxSensor.getNextDeadline(), prevIdleMs + idleTimeoutMs + 1);
+      break;
+
+    case SILLY_EXEC_SWITCH_GROUP:
+      nextMs = switchGroupTable[switchGroupIndex].getNextDeadline();
+      break;
+
+    case SILLY_EXEC_PROX_GROUP:
+      nextMs = proxGroupTable[proxGroupIndex].getNextDeadline();
+      break;
+
+    default:
+      // Something to do right away
+      return;
+  }
+
+  // Servos still on their way home
+  nextMs = scheduler::earliest(nextMs, moveSequence::getHomingDeadline());
+
+  // LED changes still waiting to be shown
+  if (!ledsShown)
+  {
+    nextMs = scheduler::earliest(nextMs, millis() + 1);
+  }
+
+  // The switch has to be looked at again once it has settled
+  if (switchSettling)
+  {
+    nextMs = scheduler::earliest(nextMs, switchSettleStartMs + switchDebounceMs);
+  }
+
+  scheduler::sleepUntil(nextMs);
 }
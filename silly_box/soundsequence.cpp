@@ -30,108 +30,128 @@
 // !! (passive) device.                                                            !!
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
-// Define preprocessor DEBUG to enable debug output.  Also, be sure to use the F macro when
-// printing strings in order to save RAM.
+// Define preprocessor TRACE to log this file's trace messages (see trace.h).
 
-//#define DEBUG
+//#define TRACE
 
 #include "soundsequence.h"
+#include "profiler.h"
 
-soundSequence::soundSequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd):sequence(pSeqTable, aSeqType, aSeqEnd)
+soundSequence::soundSequence(const void* pSeqTable, seqType aSeqType, seqEnd aSeqEnd, int8_t transpose, uint8_t tempoScale)
+  :sequence(pSeqTable, aSeqType, aSeqEnd), m_noteEndMs(0), m_voice(toneSynth::noVoice), m_transpose(transpose), m_tempoScale(tempoScale)
 {
-  startSequence();
+  // Not started here, unlike the other sequences: the first note would claim a voice (and 
+  // sound) long before the sequence's group runs.  group::start() starts it.
 }
 
 void soundSequence::setup()
 {
   // Make sure we are silent!
-  noTone(speakerPin);
+  toneSynth::setup();
 }
 
-void soundSequence::startSequence()
+void soundSequence::startSequence(uint32_t startMs)
 {
-  // Set default tempo and articulation
-  m_tempoNoteMs = 60000/TEMPO_ADAGIO/8;
-  m_articulation = ARTICULATE_STACCATO/100;
-  
+  // Make sure tone is off.  This has to come first: the base class starts the first note
+  // on a voice of its own.
+  if (m_voice != toneSynth::noVoice)
+  {
+    toneSynth::silence(m_voice);
+    toneSynth::freeVoice(m_voice);
+    m_voice = toneSynth::noVoice;
+  }
+
   // Call base class
-  sequence::startSequence();
-  
-  // Make sure tone is off
-  noTone(speakerPin);
+  sequence::startSequence(startMs);
 }
 
 void soundSequence::stopSequence() 
 {
   // Call base class
   sequence::stopSequence();
+
+  // Cut off a clip this sequence is still playing
+  if (m_seqEntry.action == ACTION_PLAY_SAMPLE && !deadlineReached()) toneSynth::stopClip();
   
-  // Make sure tone is off
-  noTone(speakerPin);
+  // Let any note die away rather than cut it off
+  if (m_voice != toneSynth::noVoice)
+  {
+    toneSynth::noteOff(m_voice);
+    toneSynth::freeVoice(m_voice);
+    m_voice = toneSynth::noVoice;
+  }
 }
 
 sequence::actionState soundSequence::executeAction()
 {
+  ProfileSection(PROF_SOUND_EXECUTE);
   if (m_seqEntry.action < ACTION_LAST_GENERIC)
   {
     // Generic action.  Call base class.
     return sequence::executeAction();
   }
 
-  if (millis() - m_prevMillis >= m_seqEntry.data2)
+  if (!deadlineReached()) return ACTION_EXECUTING;
+
+  // Note off.  The release sounds on into the rest of the note (and the next one if the
+  // articulation is 100%).
+  if (m_voice != toneSynth::noVoice) toneSynth::noteOff(m_voice);
+
+  if (static_cast<int32_t> (m_noteEndMs - m_deadlineMs) > 0)
   {
-    // Sound action delay has expired.  Turn off sound and
-    // indicate action complete.
-    noTone(speakerPin);
-    return ACTION_COMPLETE;
+    // Wait out the rest of the note
+    m_deadlineMs = m_noteEndMs;
+    return ACTION_EXECUTING;
   }
-  // If we got to here then the action is still executing
-  return ACTION_EXECUTING;
+  return ACTION_COMPLETE;
 }
 
 void soundSequence::prepareAction()
 {
+  ProfileSection(PROF_SOUND_PREPARE);
   switch (m_seqEntry.action)
   {
-    case TEMPO:
-      //
-      // Tempo is beats per minute (BPM).  Since we time all notes based on the
-      // length of a 32nd note in milliseconds, we need divide 60000ms by both the
-      // BPM and the number of 32nd notes in a quarter note.
-      // 
-      m_tempoNoteMs = 60000/m_seqEntry.data1/NOTE_QTR;
-      m_seqEntry.data2 = 0; // force action complete on next call to executeAction()
-      break;
-      
-    case ARTICULATE:
-      //
-      // Articulation is implemented as a percentage of the full duration of a note.
-      //
-      m_articulation = (static_cast<float>(m_seqEntry.data1))/100;
-      m_seqEntry.data2 = 0; // force action complete on next call to executeAction()
-      break;
+    case ACTION_NOTE:
+    {
+      // Start the note (data1 is the PITCH_XXX note number) on this sequence's voice, 
+      // claiming one with the first note.  If every voice is taken the note is silent but 
+      // still keeps time.  The deadline is the note off (data2 ms in), the note ends data3 ms
+      // in.  Both were worked out from the song's tempo and articulation when the table was
+      // compiled.
+      int16_t note = static_cast<int16_t> (m_seqEntry.data1) + m_transpose;
+      if (note < 0) note = 0;
+      else if (note >= toneSynth::numNotes) note = toneSynth::numNotes - 1;
 
-    case PITCH_REST:
-      // Reuse data2 to store the length of the rest
-      m_seqEntry.data2 = m_tempoNoteMs*m_seqEntry.data1;
-      break;
-      
-    default:
-      if (m_seqEntry.action < ACTION_LAST_GENERIC)
+      if (m_voice == toneSynth::noVoice) m_voice = toneSynth::claimVoice();
+      if (m_voice != toneSynth::noVoice) toneSynth::noteOn(m_voice, note);
+      if (m_tempoScale == TEMPO_AS_WRITTEN)
       {
-        // Generic action
-        sequence::prepareAction();
+        m_noteEndMs = m_deadlineMs + m_seqEntry.data3;
+        m_deadlineMs += m_seqEntry.data2;
       }
       else
       {
-        // By deduction must be a note
-        
-        // Reuse data2 to store the length of the note
-        m_seqEntry.data2 = m_tempoNoteMs*m_seqEntry.data1;
-        
-        // Start the tone with a duration scaled by the articulation value
-        tone(speakerPin, m_seqEntry.action, static_cast<unsigned long>(m_seqEntry.data2 * m_articulation));
+        m_noteEndMs = m_deadlineMs + scaleMs(m_seqEntry.data3);
+        m_deadlineMs += scaleMs(m_seqEntry.data2);
       }
       break;
+    }
+
+    case ACTION_DELAY:
+      // A rest (SEQ_REST), stretched like the notes
+      m_deadlineMs += scaleMs(m_seqEntry.data1);
+      break;
+
+    case ACTION_PLAY_SAMPLE:
+      // Reuse data3 to store the length of the clip (data1 is the clip)
+      m_seqEntry.data3 = toneSynth::playClip(m_seqEntry.data1);
+      m_deadlineMs += m_seqEntry.data3;
+      m_noteEndMs = m_deadlineMs;
+      break;
+
+    default:
+      // Generic action
+      sequence::prepareAction();
+      break;
   }
 }
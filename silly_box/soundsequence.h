@@ -26,27 +26,42 @@
 
 #pragma once
 #include "sequence.h"
+#include "tonesynth.h"
+
+//
+// One table can be played several ways.  transpose moves every note up (or down) that many
+// semitones and tempoScale stretches (or squeezes) the notes and rests: they last
+// tempoScale/64 of the time the table gives, so 64 plays it as written, 32 twice as fast and
+// 96 at two thirds the speed.  Clips are played as recorded.
+//
 
 class soundSequence: public sequence
 {
+  public:
+    static const uint8_t TEMPO_AS_WRITTEN = 64;
+
   // Construction/Destruction
   public:
-    soundSequence(const void*, seqType = PRIMARY_SEQ, seqEnd = ONE_SHOT);
+    soundSequence(const void*, seqType = PRIMARY_SEQ, seqEnd = ONE_SHOT, int8_t transpose = 0, uint8_t tempoScale = TEMPO_AS_WRITTEN);
 
   // Methods
   public:
     static void setup();
-    void startSequence();
+    void setTranspose(int8_t semitones) { m_transpose = semitones; }
+    void setTempoScale(uint8_t tempoScale) { m_tempoScale = tempoScale; }
+    void startSequence(uint32_t startMs);
     void stopSequence();
 
   private:
     void prepareAction();
     actionState executeAction();
+    uint32_t scaleMs(uint16_t ms) { return (static_cast<uint32_t> (ms) * m_tempoScale) >> 6; }
 
   // Attributes
   private:  
-    static const int speakerPin = 7;
     // Additional context needed for processing actions
-    uint32_t m_tempoNoteMs;
-    float m_articulation;
+    uint32_t m_noteEndMs;     // the deadline is the note off, this is the end of the note
+    uint8_t m_voice;          // toneSynth voice, claimed with the first note
+    int8_t m_transpose;       // semitones
+    uint8_t m_tempoScale;     // 64ths of the written length
 };
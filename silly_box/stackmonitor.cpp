@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the stackMonitor class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "stackmonitor.h"
+
+#ifdef __AVR__
+
+// From the linker and malloc().  __heap_start is just past the variables and __brkval is 
+// the top of the heap (0 while malloc() has never been called).
+extern uint8_t __heap_start;
+extern uint8_t* __brkval;
+
+//
+// stackMonitorPaint
+//
+// Runs from the .init1 section, before the C runtime has set anything up, so it can't use
+// the stack or count on r1 being 0.  Nothing is on the stack yet so it fills all the way
+// to the top of RAM.
+//
+
+extern "C" void stackMonitorPaint(void) __attribute__((naked, used, section(".init1")));
+
+void stackMonitorPaint(void)
+{
+  asm volatile(
+    "ldi  r30, lo8(__heap_start) \n\t"
+    "ldi  r31, hi8(__heap_start) \n\t"
+    "ldi  r24, %[paint]          \n\t"
+    "ldi  r25, hi8(%[top])       \n\t"
+    "1:                          \n\t"
+    "st   Z+, r24                \n\t"
+    "cpi  r30, lo8(%[top])       \n\t"
+    "cpc  r31, r25               \n\t"
+    "brlo 1b                     \n\t"
+    :
+    : [paint] "M" (stackMonitor::paintByte), [top] "i" (RAMEND + 1)
+  );
+}
+
+static const uint8_t* variablesEnd()
+{
+  return (__brkval != 0) ? __brkval : &__heap_start;
+}
+
+//
+// getUnusedBytes
+//
+// Counts up from the variables to the first byte the stack has written.  Takes a few hundred
+// microseconds with 1K free so call it now and then, not from every loop().
+//
+
+uint16_t stackMonitor::getUnusedBytes()
+{
+  const uint8_t* p = variablesEnd();
+  const uint8_t* pStack = reinterpret_cast<const uint8_t*> (SP);
+  uint16_t count = 0;
+
+  while (p <= pStack && *p == paintByte)
+  {
+    p++;
+    count++;
+  }
+  return count;
+}
+
+uint16_t stackMonitor::getFreeBytes()
+{
+  return reinterpret_cast<const uint8_t*> (SP) - variablesEnd();
+}
+
+uint16_t stackMonitor::getVariableBytes()
+{
+  return variablesEnd() - reinterpret_cast<const uint8_t*> (RAMSTART);
+}
+
+#else
+
+// Nothing to measure without the AVR memory layout
+uint16_t stackMonitor::getUnusedBytes()
+{
+  return 0;
+}
+
+uint16_t stackMonitor::getFreeBytes()
+{
+  return 0;
+}
+
+uint16_t stackMonitor::getVariableBytes()
+{
+  return 0;
+}
+
+#endif
@@ -0,0 +1,56 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// stackMonitor class reports how close the stack has come to the variables below it.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! The Nano has 2K of RAM.  The variables (.data and .bss, see tools/ram_report.py) sit   !!
+// !! at the bottom and the stack grows down from the top towards them.  Nothing stops it    !!
+// !! when it gets there; it just overwrites whatever variables are in the way, which shows  !!
+// !! up as servos or LEDs doing odd things rather than as a crash.                          !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+//
+// Before anything else runs the space between the variables and the top of RAM is filled 
+// with paintByte.  getUnusedBytes() counts how much of it, from the variables up, still 
+// holds paintByte: the closest the stack (or an interrupt on top of it) has come since 
+// reset.  getFreeBytes() is the space between them right now and getVariableBytes() the RAM
+// below it taken by variables (and the heap).
+//
+
+class stackMonitor
+{
+  public:
+    static const uint8_t paintByte = 0xC5;
+
+  // Methods
+  public:
+    static uint16_t getUnusedBytes();
+    static uint16_t getFreeBytes();
+    static uint16_t getVariableBytes();
+};
@@ -44,22 +44,24 @@
 //
 //    The set of possible actions is defined in the "action.h" header file.  In this file you
 //    will also find documented the data required for each action (if necessary).  There may 
-//    be up to 3 32 bit data fields associated with each action.  Note that the structure
-//    'sequence::seqEntry' is the data structure that fully defines an action
+//    be up to 3 data fields associated with each action, each only as wide as the action
+//    needs.  Actions are written into a table with the matching SEQ_XXX macro from "action.h"
+//    (e.g. 'SEQ_DELAY(200)' or 'SEQ_MOVE_ARM(65, 40, 0)') which packs the opcode and its
+//    data into as few bytes as possible.
 //
 //  Sequence Specification:
 //
-//    1) Sequence tables MUST be defined with the keyword 'const' and in PROGMEM 
+//    1) Sequence tables MUST be defined as 'const uint8_t' arrays and in PROGMEM 
 //       (program memory).  This is what allows us to fit this application within
 //       UNO and Nano memory constraints.
 //
-//    2) All sequence tables must end with the enum value 'ACTION_END' to indicate the end 
-//       of the sequence tables.
+//    2) All sequence tables must end with 'SEQ_END()' to indicate the end of the 
+//       sequence tables.
 //
 //    3) You cannot mix movement, LED, and sound actions within the same sequence table.
 //
-//    4) 'ACTION_DELAY' enum can be used in any sequence (movement, LED, or sound).  This
-//       and 'ACTION_END' are the only generic action enums shared.
+//    4) 'SEQ_DELAY' can be used in any sequence (movement, LED, or sound).  This and 
+//       'SEQ_END' are the only generic actions shared.
 //
 //    5) When instantiating a sequence object you MUST pass the address of the sequence table.
 //       Optional arguments are seqType (2nd argument) and seqEnd (3rd) argument.
@@ -88,6 +90,12 @@
 //
 //    8) If the 'movesequence' object is part of a switch group then you will want to make sure
 //       you have an action that turns the front switch off!
+//
+//    9) Repeated actions can be written once with 'SEQ_LOOP(n)' ... 'SEQ_NEXT()' and fragments
+//       shared between tables can be moved into a subroutine (see "Flow control" in action.h).
+//       A subroutine is a sequence table that ends with 'SEQ_RET()' rather than 'SEQ_END()'
+//       and is listed in 'seqSubroutineTable'.  Like any other table it must only contain 
+//       actions of the type of sequence calling it.
 //    
 //  Group Specification:
 //
@@ -98,7 +106,8 @@
 //    2) The last entry in a group table must be NULL.
 //
 //    3) There can only be one (1) primary sequence (PRIMARY_SEQ) object in a group table.
-//       There can be multiple secondary sequence (SECONDARY_SEQ) objects in a group table.
+//       There can be multiple secondary sequence (SECONDARY_SEQ) objects in a group table,
+//       up to a total of 'sequence::maxGroupSequences' sequences (checked when compiling).
 //
 //    4) The 'loop()' function requires a table of group objects called 'switchGroupTable' in
 //       order to randomly choose a group to execute when the front switch is turned on.
@@ -131,370 +140,310 @@
 #include "movesequence.h"
 #include "ledsequence.h"
 #include "soundsequence.h"
+#include "clips.h"
 #include "group.h"
 
+///////////////////////////////////////////////////////////////////////////////
+// S u b r o u t i n e s 
+///////////////////////////////////////////////////////////////////////////////
+
+// Index of each subroutine in 'seqSubroutineTable'.  Keep in the same order!
+enum subroutineEnum
+{
+  SUB_RETRACT_AND_CLOSE,
+  SUB_LID_FLUTTER,
+  SUB_ARM_WAVE
+};
+
+// Pull the arm in and shut the lid
+const uint8_t subRetractAndClose[] PROGMEM = 
+{
+  SEQ_RETRACT_ARM(),
+  SEQ_DELAY(500),
+  SEQ_CLOSE_LID(),
+  SEQ_RET()
+};
+
+// Pop the lid open and slam it shut
+const uint8_t subLidFlutter[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(200),
+  SEQ_CLOSE_LID(),
+  SEQ_RET()
+};
+
+// Wave the arm once from 65 to 40 degrees and back
+const uint8_t subArmWave[] PROGMEM = 
+{
+  SEQ_MOVE_ARM(65, 40, 0),
+  SEQ_DELAY(200),
+  SEQ_MOVE_ARM(40, 65, 0),
+  SEQ_DELAY(200),
+  SEQ_RET()
+};
+
+const uint8_t* const seqSubroutineTable[] PROGMEM = 
+{
+  subRetractAndClose,
+  subLidFlutter,
+  subArmWave
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // M o v e   S e q u e n c e s 
 ///////////////////////////////////////////////////////////////////////////////
 
-const sequence::seqEntry moveTable1[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 20},
-  {ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, 20},
-  {ACTION_DELAY, 1000},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 200},
-  {ACTION_RETRACT_ARM_FROM_EXTENDED, 20},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID_FROM_OPEN, 20},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable2[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 550},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 550},
-  {ACTION_CLOSE_LID},
-  {ACTION_DELAY, 1500},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 3000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable3[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_DELAY, 2000},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable4[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 20},
-  {ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, 20},
-  {ACTION_DELAY, 2000},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 400},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable5[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 2000},
-  {ACTION_MOVE_ARM, moveSequence::armRetractedAngle, 65, 0},
-  {ACTION_DELAY, 550},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 600},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable6[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 20},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, 30},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 400},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_DELAY, 1500},
-  {ACTION_OPEN_LID_FROM_CLOSE, 20},
-  {ACTION_DELAY, 3000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable7[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 400},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 200},
-  {ACTION_CLOSE_LID},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 700},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable8[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 2000},
-  {ACTION_MOVE_ARM, moveSequence::armExtendedAngle, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 75, 40, 0},
-  {ACTION_DELAY, 100},
-  {ACTION_MOVE_ARM, 40, 75, 0},
-  {ACTION_DELAY, 600},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable9[] PROGMEM = 
-{
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 6},
-  {ACTION_DELAY, 2000},
-  {ACTION_OPEN_LID},
-  {ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, 40},
-  {ACTION_DELAY, 500},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_RETRACT_ARM_FROM_EXTENDED, 40},
-  {ACTION_CLOSE_LID},
-  {ACTION_DELAY, 2000},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 0},
-  {ACTION_DELAY, 3000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable10[] PROGMEM = 
-{
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 100},
-  {ACTION_DELAY, 2000},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_CLOSE_LID},
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 6},
-  {ACTION_DELAY, 100},
-  {ACTION_OPEN_LID},
-  {ACTION_DELAY, 100},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable11[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 2000},
-  {ACTION_MOVE_ARM, moveSequence::armExtendedAngle, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 40, 65, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 65, 40, 0},
-  {ACTION_DELAY, 1700},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 400},
-  {ACTION_CLOSE_LID},
-  {ACTION_DELAY, 1500},
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 3000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable12[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 50},
-  {ACTION_DELAY, 1000},
-  {ACTION_EXTEND_ARM_FROM_RETRACTED, 50},
-  {ACTION_DELAY, 2000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
-};
-
-const sequence::seqEntry moveTable13[] PROGMEM = 
-{
-  {ACTION_OPEN_LID_FROM_CLOSE, 6},
-  {ACTION_DELAY, 2000},
-  {ACTION_MOVE_ARM, moveSequence::armRetractedAngle, 60, 40},
-  {ACTION_MOVE_ARM, 60, 40, 0},
-  {ACTION_DELAY, 800},
-  {ACTION_MOVE_ARM, 40, 60, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 60, 40, 0},
-  {ACTION_DELAY, 800},
-  {ACTION_MOVE_ARM, 40, 60, 0},
-  {ACTION_DELAY, 200},
-  {ACTION_MOVE_ARM, 60, 40, 0},
-  {ACTION_DELAY, 800},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 2000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
+// Open the lid and strike the switch in one motion.  The arm sets off once the lid is 20 
+// degrees open rather than waiting for it to finish opening.
+#define SEQ_OPEN_LID_AND_STRIKE() \
+  SEQ_PROFILE_LID_ARM(moveSequence::lidClosedAngle, moveSequence::lidOpenedAngle, \
+                      moveSequence::armRetractedAngle, moveSequence::armExtendedAngle, PROFILE_STRIKE, 20)
+
+const uint8_t moveTable1[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(20),
+  SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(20),
+  SEQ_DELAY(1000),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(200),
+  SEQ_RETRACT_ARM_FROM_EXTENDED(20),
+  SEQ_DELAY(200),
+  SEQ_CLOSE_LID_FROM_OPEN(20),
+  SEQ_END()
+};
+
+const uint8_t moveTable2[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(550),
+  SEQ_PROFILE_ARM(moveSequence::armRetractedAngle, moveSequence::armExtendedAngle, PROFILE_STRIKE),
+  SEQ_DELAY(1000),
+  SEQ_RETRACT_ARM(),
+  SEQ_DELAY(550),
+  SEQ_CLOSE_LID(),
+  SEQ_DELAY(1500),
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(3000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
+};
+
+const uint8_t moveTable3[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_DELAY(2000),
+  SEQ_OPEN_LID_AND_STRIKE(),
+  SEQ_DELAY(1000),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable4[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(20),
+  SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(20),
+  SEQ_DELAY(2000),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(400),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable5[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(2000),
+  SEQ_MOVE_ARM(moveSequence::armRetractedAngle, 65, 0),
+  SEQ_DELAY(550),
+  SEQ_LOOP(5),
+    SEQ_CALL(SUB_ARM_WAVE),
+  SEQ_NEXT(),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(600),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable6[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(20),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_LOOP(5),
+    SEQ_CALL(SUB_LID_FLUTTER),
+  SEQ_NEXT(),
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(200),
+  SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(30),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(400),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_DELAY(1500),
+  SEQ_OPEN_LID_FROM_CLOSE(20),
+  SEQ_DELAY(3000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
+};
+
+const uint8_t moveTable7[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(400),
+  SEQ_PROFILE_ARM(moveSequence::armRetractedAngle, moveSequence::armExtendedAngle, PROFILE_STRIKE),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_LOOP(5),
+    SEQ_CALL(SUB_LID_FLUTTER),
+  SEQ_NEXT(),
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(700),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable8[] PROGMEM = 
+{
+  SEQ_OPEN_LID_AND_STRIKE(),
+  SEQ_DELAY(2000),
+  SEQ_MOVE_ARM(moveSequence::armExtendedAngle, 75, 0),
+  SEQ_DELAY(100),
+  SEQ_LOOP(6),
+    SEQ_MOVE_ARM(75, 40, 0),
+    SEQ_DELAY(100),
+    SEQ_MOVE_ARM(40, 75, 0),
+    SEQ_DELAY(100),
+  SEQ_NEXT(),
+  SEQ_MOVE_ARM(75, 40, 0),
+  SEQ_DELAY(100),
+  SEQ_MOVE_ARM(40, 75, 0),
+  SEQ_DELAY(600),
+  SEQ_RETRACT_ARM(),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
+};
+
+const uint8_t moveTable9[] PROGMEM = 
+{
+  SEQ_PEEK_LID_FROM_CLOSE(15, 6),
+  SEQ_DELAY(2000),
+  SEQ_OPEN_LID(),
+  SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(40),
+  SEQ_DELAY(500),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(500),
+  SEQ_RETRACT_ARM_FROM_EXTENDED(40),
+  SEQ_CLOSE_LID(),
+  SEQ_DELAY(2000),
+  SEQ_PEEK_LID_FROM_CLOSE(20, 0),
+  SEQ_DELAY(3000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
+};
+
+const uint8_t moveTable10[] PROGMEM = 
+{
+  SEQ_PEEK_LID_FROM_CLOSE(15, 100),
+  SEQ_DELAY(2000),
+  SEQ_CLOSE_LID(),
+  SEQ_LOOP(9),
+    SEQ_PEEK_LID_FROM_CLOSE(20, 6),
+    SEQ_DELAY(100),
+    SEQ_CLOSE_LID(),
+  SEQ_NEXT(),
+  SEQ_PEEK_LID_FROM_CLOSE(20, 6),
+  SEQ_DELAY(100),
+  SEQ_OPEN_LID(),
+  SEQ_DELAY(100),
+  SEQ_PROFILE_ARM(moveSequence::armRetractedAngle, moveSequence::armExtendedAngle, PROFILE_STRIKE),
+  SEQ_DELAY(1000),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable11[] PROGMEM = 
+{
+  SEQ_OPEN_LID_AND_STRIKE(),
+  SEQ_DELAY(2000),
+  SEQ_MOVE_ARM(moveSequence::armExtendedAngle, 65, 0),
+  SEQ_DELAY(200),
+  SEQ_LOOP(2),
+    SEQ_CALL(SUB_ARM_WAVE),
+  SEQ_NEXT(),
+  SEQ_MOVE_ARM(65, 40, 0),
+  SEQ_DELAY(1700),
+  SEQ_RETRACT_ARM(),
+  SEQ_DELAY(400),
+  SEQ_CLOSE_LID(),
+  SEQ_DELAY(1500),
+  SEQ_OPEN_LID_AND_STRIKE(),
+  SEQ_DELAY(3000),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable12[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(50),
+  SEQ_DELAY(1000),
+  SEQ_EXTEND_ARM_FROM_RETRACTED(50),
+  SEQ_DELAY(2000),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
+};
+
+const uint8_t moveTable13[] PROGMEM = 
+{
+  SEQ_OPEN_LID_FROM_CLOSE(6),
+  SEQ_DELAY(2000),
+  SEQ_MOVE_ARM(moveSequence::armRetractedAngle, 60, 40),
+  SEQ_LOOP(2),
+    SEQ_MOVE_ARM(60, 40, 0),
+    SEQ_DELAY(800),
+    SEQ_MOVE_ARM(40, 60, 0),
+    SEQ_DELAY(200),
+  SEQ_NEXT(),
+  SEQ_MOVE_ARM(60, 40, 0),
+  SEQ_DELAY(800),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(2000),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
 };
     
-const sequence::seqEntry moveTable14[] PROGMEM = 
-{
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 6},
-  {ACTION_DELAY, 4000},
-  {ACTION_OPEN_LID},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 1000},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_MOVE_LID, moveSequence::lidOpenedAngle, moveSequence::lidOpenedAngle - 10, 0},
-  {ACTION_DELAY, 4000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
+const uint8_t moveTable14[] PROGMEM = 
+{
+  SEQ_PEEK_LID_FROM_CLOSE(15, 6),
+  SEQ_DELAY(4000),
+  SEQ_OPEN_LID(),
+  SEQ_PROFILE_ARM(moveSequence::armRetractedAngle, moveSequence::armExtendedAngle, PROFILE_STRIKE),
+  SEQ_DELAY(1000),
+  SEQ_RETRACT_ARM(),
+  SEQ_DELAY(500),
+  SEQ_MOVE_LID(moveSequence::lidOpenedAngle, moveSequence::lidOpenedAngle - 10, 0),
+  SEQ_DELAY(4000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
 };
    
-const sequence::seqEntry moveTable15[] PROGMEM = 
-{
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 6},
-  {ACTION_DELAY, 1000},
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 50},
-  {ACTION_CLOSE_LID_FROM_PEEK, 15, 50},
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 50},
-  {ACTION_CLOSE_LID_FROM_PEEK, 15, 50},
-  {ACTION_PEEK_LID_FROM_CLOSE, 15, 50},
-  {ACTION_CLOSE_LID_FROM_PEEK, 15, 50},
-  {ACTION_OPEN_LID_FROM_CLOSE, 50},
-  {ACTION_ALMOST_EXTEND_ARM_FROM_RETRACTED, 40},
-  {ACTION_DELAY, 1000},
-  {ACTION_EXTEND_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_RETRACT_ARM},
-  {ACTION_DELAY, 500},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
+const uint8_t moveTable15[] PROGMEM = 
+{
+  SEQ_PEEK_LID_FROM_CLOSE(15, 6),
+  SEQ_DELAY(1000),
+  SEQ_LOOP(3),
+    SEQ_PEEK_LID_FROM_CLOSE(15, 50),
+    SEQ_CLOSE_LID_FROM_PEEK(15, 50),
+  SEQ_NEXT(),
+  SEQ_OPEN_LID_FROM_CLOSE(50),
+  SEQ_ALMOST_EXTEND_ARM_FROM_RETRACTED(40),
+  SEQ_DELAY(1000),
+  SEQ_EXTEND_ARM(),
+  SEQ_DELAY(500),
+  SEQ_CALL(SUB_RETRACT_AND_CLOSE),
+  SEQ_END()
 };
 
 moveSequence moveSequence1(moveTable1);
@@ -513,20 +462,20 @@ moveSequence moveSequence13(moveTable13);
 moveSequence moveSequence14(moveTable14);
 moveSequence moveSequence15(moveTable15);
 
-const sequence::seqEntry proxMoveTable1[] PROGMEM = 
+const uint8_t proxMoveTable1[] PROGMEM = 
 {
-  {ACTION_PEEK_LID_FROM_CLOSE, 20, 20},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
+  SEQ_PEEK_LID_FROM_CLOSE(20, 20),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
 };
 
-const sequence::seqEntry proxMoveTable2[] PROGMEM = 
+const uint8_t proxMoveTable2[] PROGMEM = 
 {
-  {ACTION_OPEN_LID},
-  {ACTION_DELAY, 1000},
-  {ACTION_CLOSE_LID},
-  {ACTION_END}
+  SEQ_OPEN_LID(),
+  SEQ_DELAY(1000),
+  SEQ_CLOSE_LID(),
+  SEQ_END()
 };
 
 moveSequence proxMoveSequence1(proxMoveTable1);
@@ -538,93 +487,93 @@ moveSequence proxMoveSequence3(moveTable14);
 // L E D   S e q u e n c e s 
 ///////////////////////////////////////////////////////////////////////////////
 
-const sequence::seqEntry ledFastRotation[] PROGMEM = 
+const uint8_t ledFastRotation[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clRed},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clGreen},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clBlue},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clYellow},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clRed),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clGreen),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clBlue),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clYellow),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
   
 // Slow color rotation
-const sequence::seqEntry ledSlowRotation[] PROGMEM = 
+const uint8_t ledSlowRotation[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clRed},
-  {ACTION_DELAY, 500},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS,  clGreen},
-  {ACTION_DELAY, 500},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clBlue},
-  {ACTION_DELAY, 500},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS,  clYellow},
-  {ACTION_DELAY, 500},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clRed),
+  SEQ_DELAY(500),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clGreen),
+  SEQ_DELAY(500),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clBlue),
+  SEQ_DELAY(500),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clYellow),
+  SEQ_DELAY(500),
+  SEQ_END()
 };
 
 // Fast red blink
-const sequence::seqEntry ledFastRedBlink[] PROGMEM = 
+const uint8_t ledFastRedBlink[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clRed},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS,  clBlack},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clRed),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clBlack),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Fast red/yellow blink
-const sequence::seqEntry ledFastRedYellowBlink[] PROGMEM = 
+const uint8_t ledFastRedYellowBlink[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clRed},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS,  clYellow},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clRed),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clYellow),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Fast blue/yellow blink
-const sequence::seqEntry ledFastBlueYellowBlink[] PROGMEM = 
+const uint8_t ledFastBlueYellowBlink[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clBlue},
-  {ACTION_DELAY, 200},
-  {ACTION_SET_LED, ledSequence::ALL_LEDS,  clYellow},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clBlue),
+  SEQ_DELAY(200),
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clYellow),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Solid Red
-const sequence::seqEntry ledSolidRed[] PROGMEM = 
+const uint8_t ledSolidRed[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clRed},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clRed),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Solid Green
-const sequence::seqEntry ledSolidGreen[] PROGMEM = 
+const uint8_t ledSolidGreen[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clGreen},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clGreen),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Solid Blue
-const sequence::seqEntry ledSolidBlue[] PROGMEM = 
+const uint8_t ledSolidBlue[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clBlue},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clBlue),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 // Solid Yellow
-const sequence::seqEntry ledSolidYellow[] PROGMEM = 
+const uint8_t ledSolidYellow[] PROGMEM = 
 {
-  {ACTION_SET_LED, ledSequence::ALL_LEDS, clYellow},
-  {ACTION_DELAY, 200},
-  {ACTION_END}
+  SEQ_SET_LED(ledSequence::ALL_LEDS, clYellow),
+  SEQ_DELAY(200),
+  SEQ_END()
 };
 
 ledSequence ledFastRotationSequence(ledFastRotation, sequence::SECONDARY_SEQ, sequence::REPEATING); 
@@ -642,82 +591,94 @@ ledSequence ledSolidYellowSequence(ledSolidYellow, sequence::SECONDARY_SEQ, sequ
 // S o u n d   S e q u e n c e s 
 ///////////////////////////////////////////////////////////////////////////////
 
-const sequence::seqEntry soundStarsStripesTbl[] PROGMEM = 
-{
-  {TEMPO, TEMPO_ALLEGRO}, 
-  {ARTICULATE, ARTICULATE_STACCATO},
-  {PITCH_EF4, NOTE_QTR},
-  {PITCH_D4, NOTE_DOT_8TH},
-  {PITCH_EF4, NOTE_16TH},
-  {PITCH_C4, NOTE_8TH},
-  {PITCH_EF4, NOTE_QTR},
-  {PITCH_F4, NOTE_8TH},
-  {PITCH_GF4, NOTE_8TH},
-  {PITCH_G4, NOTE_8TH},
-  {PITCH_AF4, NOTE_8TH},
-  {PITCH_A4, NOTE_8TH},
-  {PITCH_BF4, NOTE_8TH},
-  {ACTION_END}
-};
-
-const sequence::seqEntry soundChargeTbl[] PROGMEM = 
-{
-  {TEMPO, TEMPO_ALLEGRO}, 
-  {ARTICULATE, ARTICULATE_STACCATO},
-  {PITCH_G3, NOTE_8TH},
-  {PITCH_C4, NOTE_8TH},
-  {PITCH_E4, NOTE_8TH},
-  {PITCH_G4, NOTE_DOT_8TH},
-  {PITCH_E4, NOTE_16TH},
-  {PITCH_G4, NOTE_QTR},
-  {ACTION_END}
-};
-
-const sequence::seqEntry soundBackUpTbl[] PROGMEM = 
-{
-  {TEMPO, TEMPO_ALLEGRO}, 
-  {ARTICULATE, ARTICULATE_STACCATO},
-  {PITCH_B5, NOTE_QTR},
-  {PITCH_REST, NOTE_QTR},
-  {PITCH_B5, NOTE_QTR},
-  {PITCH_REST, NOTE_QTR},
-  {PITCH_B5, NOTE_QTR},
-  {PITCH_REST, NOTE_QTR},
-  {PITCH_B5, NOTE_QTR},
-  {PITCH_REST, NOTE_QTR},
-  {ACTION_END}
-};
-
-const sequence::seqEntry soundAnnoyedTbl[] PROGMEM = 
-{
-  {TEMPO, TEMPO_ALLEGRO}, 
-  {ARTICULATE, ARTICULATE_STACCATO},
-  {PITCH_C2, NOTE_HALF},
-  {ACTION_END}
-};
-
-const sequence::seqEntry soundFussyTbl[] PROGMEM = 
-{
-  {TEMPO, TEMPO_ALLEGRO}, 
-  {ARTICULATE, ARTICULATE_STACCATO},
-  {PITCH_B3, NOTE_8TH},
-  {PITCH_REST, NOTE_QTR},
-  {PITCH_B3, NOTE_16TH},
-  {PITCH_G3, NOTE_16TH},
-  {PITCH_REST, NOTE_QTR},
-  {PITCH_F3, NOTE_DOT_8TH},
-  {PITCH_A3, NOTE_8TH},
-  {PITCH_BF3, NOTE_8TH},
-  {PITCH_BF3, NOTE_8TH},
-  {ACTION_END}
+constexpr songStyle starsStripesStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+const uint8_t soundStarsStripesTbl[] PROGMEM = 
+{
+  SEQ_NOTE(starsStripesStyle, PITCH_EF4, NOTE_QTR),
+  SEQ_NOTE(starsStripesStyle, PITCH_D4, NOTE_DOT_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_EF4, NOTE_16TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_C4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_EF4, NOTE_QTR),
+  SEQ_NOTE(starsStripesStyle, PITCH_F4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_GF4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_G4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_AF4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_A4, NOTE_8TH),
+  SEQ_NOTE(starsStripesStyle, PITCH_BF4, NOTE_8TH),
+  SEQ_END()
+};
+
+constexpr songStyle chargeStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+const uint8_t soundChargeTbl[] PROGMEM = 
+{
+  SEQ_NOTE(chargeStyle, PITCH_G3, NOTE_8TH),
+  SEQ_NOTE(chargeStyle, PITCH_C4, NOTE_8TH),
+  SEQ_NOTE(chargeStyle, PITCH_E4, NOTE_8TH),
+  SEQ_NOTE(chargeStyle, PITCH_G4, NOTE_DOT_8TH),
+  SEQ_NOTE(chargeStyle, PITCH_E4, NOTE_16TH),
+  SEQ_NOTE(chargeStyle, PITCH_G4, NOTE_QTR),
+  SEQ_END()
+};
+
+// Bass line under soundCharge, on a voice of its own
+constexpr songStyle chargeBassStyle(TEMPO_ALLEGRO, ARTICULATE_LEGATO);
+const uint8_t soundChargeBassTbl[] PROGMEM = 
+{
+  SEQ_NOTE(chargeBassStyle, PITCH_C3, NOTE_DOT_QTR),
+  SEQ_NOTE(chargeBassStyle, PITCH_G2, NOTE_8TH),
+  SEQ_NOTE(chargeBassStyle, PITCH_C3, NOTE_DOT_QTR),
+  SEQ_END()
+};
+
+constexpr songStyle backUpStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+const uint8_t soundBackUpTbl[] PROGMEM = 
+{
+  SEQ_LOOP(4),
+    SEQ_NOTE(backUpStyle, PITCH_B5, NOTE_QTR),
+    SEQ_REST(backUpStyle, NOTE_QTR),
+  SEQ_NEXT(),
+  SEQ_END()
+};
+
+constexpr songStyle annoyedStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+const uint8_t soundAnnoyedTbl[] PROGMEM = 
+{
+  SEQ_NOTE(annoyedStyle, PITCH_C2, NOTE_HALF),
+  SEQ_END()
+};
+
+// A recorded clip (see clips.h).  sounds/grumble.wav is a synthesized stand-in, so this isn't
+// in a group yet.
+const uint8_t soundGrumbleTbl[] PROGMEM = 
+{
+  SEQ_PLAY_SAMPLE(CLIP_GRUMBLE),
+  SEQ_END()
+};
+
+constexpr songStyle fussyStyle(TEMPO_ALLEGRO, ARTICULATE_STACCATO);
+const uint8_t soundFussyTbl[] PROGMEM = 
+{
+  SEQ_NOTE(fussyStyle, PITCH_B3, NOTE_8TH),
+  SEQ_REST(fussyStyle, NOTE_QTR),
+  SEQ_NOTE(fussyStyle, PITCH_B3, NOTE_16TH),
+  SEQ_NOTE(fussyStyle, PITCH_G3, NOTE_16TH),
+  SEQ_REST(fussyStyle, NOTE_QTR),
+  SEQ_NOTE(fussyStyle, PITCH_F3, NOTE_DOT_8TH),
+  SEQ_NOTE(fussyStyle, PITCH_A3, NOTE_8TH),
+  SEQ_NOTE(fussyStyle, PITCH_BF3, NOTE_8TH),
+  SEQ_NOTE(fussyStyle, PITCH_BF3, NOTE_8TH),
+  SEQ_END()
 };
 
 soundSequence soundFussy(soundFussyTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
 soundSequence soundAnnoyed(soundAnnoyedTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
+soundSequence soundGrumble(soundGrumbleTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
 soundSequence soundBackUp(soundBackUpTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
 soundSequence soundBackUpC(soundBackUpTbl, sequence::SECONDARY_SEQ, sequence::REPEATING);
 soundSequence soundStarsStripes(soundStarsStripesTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
+soundSequence soundStarsStripesLow(soundStarsStripesTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT, -5, 96);  // A fourth down, two thirds the speed
 soundSequence soundCharge(soundChargeTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
+soundSequence soundChargeBass(soundChargeBassTbl, sequence::SECONDARY_SEQ, sequence::ONE_SHOT);
 
 ///////////////////////////////////////////////////////////////////////////////
 // S w i t c h   G r o u p s 
@@ -736,6 +697,7 @@ sequence* const group2[] PROGMEM =
   &moveSequence2,  
   &ledSlowRotationSequence,        
   &soundCharge, 
+  &soundChargeBass, 
   NULL
 };
 
@@ -752,6 +714,7 @@ sequence* const group4[] PROGMEM =
   &moveSequence4,  
   &ledFastRedYellowBlinkSequence,  
   &soundCharge, 
+  &soundChargeBass, 
   NULL
 };
 
@@ -823,7 +786,7 @@ sequence* const group13[] PROGMEM =
 {
   &moveSequence13, 
   &ledFastBlueYellowBlinkSequence, 
-  &soundStarsStripes, 
+  &soundStarsStripesLow, 
   NULL
 };
 
@@ -840,6 +803,7 @@ sequence* const group15[] PROGMEM =
   &moveSequence15, 
   &ledSolidBlueSequence,
   &soundCharge, 
+  &soundChargeBass, 
   NULL
 };
 
@@ -865,6 +829,10 @@ group switchGroupTable[] =
 
 int numSwitchGroups = sizeof(switchGroupTable)/sizeof(switchGroupTable[0]);
 
+// Checked whether or not REACTION_TIMER is defined so the two are kept in step
+static_assert(sizeof(switchGroupTable)/sizeof(switchGroupTable[0]) == reactionTimer::maxGroups, 
+              "reactionTimer::maxGroups must be the number of groups in switchGroupTable");
+
 ///////////////////////////////////////////////////////////////////////////////
 // P r o x i m i t y   G r o u p s 
 ///////////////////////////////////////////////////////////////////////////////
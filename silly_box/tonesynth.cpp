@@ -0,0 +1,566 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the toneSynth class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! Interrupt cost                                                                         !!
+// !!                                                                                        !!
+// !! Timer2 overflows every 510 cycles (31.4kHz) while anything sounds.  The overflow       !!
+// !! interrupt is written in assembler so the odd overflows, which only count, take about  !!
+// !! 30 cycles.  A C interrupt would save every register the sample code uses on every      !!
+// !! overflow.  The even ones go on to the sample handler: about 110 cycles with its        !!
+// !! register saves, plus about 30 for each voice sounding, plus about 40 on the samples    !!
+// !! that step a voice's envelope.  A playing clip adds about 20 cycles a sample and about  !!
+// !! 90 more every other sample to decode it.                                              !!
+// !!                                                                                        !!
+// !! That's roughly 18% of the processor with one voice, 23% with all 3, about 6% more      !!
+// !! for a clip, and nothing between notes.  The longest single interrupt, 3 voices and a   !!
+// !! clip, is about 330 cycles (21us).  Define PROFILE (see profiler.h) to measure it;      !!
+// !! getCpuPermille() reports the time in the sample handler read from Timer1 (0.5us per    !!
+// !! count) like ledPwm does.                                                               !!
+// !!                                                                                        !!
+// !! Living with the Servo library: an interrupt can't interrupt another so the Servo       !!
+// !! library's Timer1 compare can start a pulse edge up to one of these late, about 2       !!
+// !! degrees at worst and well under 1 degree with a single voice.  The other way around, a !!
+// !! late sample just repeats the previous duty cycle for one more period.                 !!
+// !!                                                                                        !!
+// !! Timer2 is the timer tone() uses so tone() must not be used alongside this.  It also    !!
+// !! drives analogWrite() on pins 3 and 11; 11 is only the test mode input.                 !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+#include "tonesynth.h"
+#include "profiler.h"
+
+toneSynth::voiceState toneSynth::s_voices[numVoices];
+uint8_t toneSynth::s_claimed = 0;
+const uint8_t* toneSynth::s_pClip;
+uint16_t toneSynth::s_clipRemaining = 0;
+int16_t toneSynth::s_clipPredictor;
+uint8_t toneSynth::s_clipIndex;
+bool toneSynth::s_clipHighNibble;
+uint8_t toneSynth::s_clipOut = 0;
+uint16_t toneSynth::s_attackStep;
+uint16_t toneSynth::s_decayStep;
+uint16_t toneSynth::s_sustainLevel;
+uint16_t toneSynth::s_releaseStep;
+
+// Timer2 overflows, counted by the interrupt.  Even counts make a sample.
+static volatile uint8_t overflowCount = 0;
+
+#ifdef PROFILE
+// Interrupt cost measurement
+static const uint8_t isrEntryExitCounts = 4;  // register save/restore not seen by Timer1 (~32 cycles)
+static volatile uint32_t busyCounts = 0;       // Timer1 counts spent in the interrupt
+static uint32_t windowStartUs = 0;
+#endif
+
+//
+// One cycle of a sine wave, offset to 0 - 255.  A zero envelope scales every entry to 0 so 
+// the output can be switched off without a click.
+//
+
+const uint8_t toneSynth::waveTable[256] PROGMEM =
+{
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+  176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+  245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+  255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+  245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+  176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+  128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+   79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+   37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+   10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+    0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+   10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+   37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+   79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+//
+// Phase step of each MIDI note (equal temperament, A4 = note 69 = 440Hz): the frequency in
+// 1/65536ths of a cycle per sample, so starting a note is a table lookup.  Made for this 
+// sample rate with round(440 * 2^((note - 69)/12) * 65536 / sampleRateHz).
+//
+
+static_assert(toneSynth::sampleRateHz == 15686, "noteStepTable needs working out again for the new sample rate");
+
+const uint16_t toneSynth::noteStepTable[numNotes] PROGMEM =
+{
+     34,    36,    38,    41,    43,    46,    48,    51,    54,    57,    61,    64,  // 0 - 11
+     68,    72,    77,    81,    86,    91,    97,   102,   108,   115,   122,   129,  // 12 - 23
+    137,   145,   153,   162,   172,   182,   193,   205,   217,   230,   243,   258,  // 24 - 35
+    273,   290,   307,   325,   344,   365,   386,   409,   434,   460,   487,   516,  // 36 - 47
+    547,   579,   613,   650,   689,   730,   773,   819,   868,   919,   974,  1032,  // 48 - 59
+   1093,  1158,  1227,  1300,  1377,  1459,  1546,  1638,  1735,  1838,  1948,  2063,  // 60 - 71
+   2186,  2316,  2454,  2600,  2754,  2918,  3092,  3276,  3470,  3677,  3895,  4127,  // 72 - 83
+   4372,  4632,  4908,  5200,  5509,  5836,  6183,  6551,  6941,  7353,  7791,  8254,  // 84 - 95
+   8745,  9265,  9815, 10399, 11017, 11673, 12367, 13102, 13881, 14707, 15581, 16508,  // 96 - 107
+  17489, 18529, 19631, 20798, 22035, 23345, 24733, 26204, 27762, 29413, 31162, 33015,  // 108 - 119
+  34978, 37058, 39262, 41596, 44070, 46690, 49467, 52408  // 120 - 127
+};
+
+//
+// IMA-ADPCM tables (the standard ones, also in tools/adpcm_encode.py)
+//
+
+const uint16_t toneSynth::stepTable[89] PROGMEM =
+{
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279,
+  307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411,
+  1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+  5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+  20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const int8_t toneSynth::indexTable[8] PROGMEM =
+{
+  -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+//
+// sample
+//
+// Makes one sample.  Called from the sample handler on the even Timer2 overflows.
+//
+
+inline void toneSynth::sample()
+{
+  uint8_t count = overflowCount;
+
+  // Mix, clipped to the duty cycle (see voiceGain)
+  uint16_t mix = 0;
+  for (uint8_t i = 0; i < numVoices; i++)
+  {
+    voiceState& voice = s_voices[i];
+    if (voice.stage == STAGE_IDLE) continue;
+
+    voice.phase += voice.phaseStep;
+    uint8_t wave = pgm_read_byte_near(&waveTable[voice.phase >> 8]);
+    mix += (static_cast<uint16_t> (wave) * voice.amplitude) >> 8;
+  }
+  if (s_clipRemaining)
+  {
+    if (!(count & 0x02)) clipStep();
+    mix += s_clipOut;
+  }
+  OCR2B = (mix > 0xFF) ? 0xFF : mix;
+
+  // One voice's envelope per sample, each voice every envelopeSamples samples
+  uint8_t envelopeVoice = (count >> 1) & (envelopeSamples - 1);
+  if (envelopeVoice < numVoices) envelopeStep(s_voices[envelopeVoice]);
+}
+
+//
+// envelopeStep
+//
+// Moves a voice's envelope level one step through the ADSR stages
+//
+
+inline void toneSynth::envelopeStep(voiceState& voice)
+{
+  switch (voice.stage)
+  {
+    case STAGE_ATTACK:
+      if (voice.level > 0xFFFF - s_attackStep)
+      {
+        voice.level = 0xFFFF;
+        voice.stage = STAGE_DECAY;
+      }
+      else voice.level += s_attackStep;
+      break;
+
+    case STAGE_DECAY:
+      if (voice.level < s_sustainLevel + s_decayStep)
+      {
+        voice.level = s_sustainLevel;
+        voice.stage = STAGE_SUSTAIN;
+      }
+      else voice.level -= s_decayStep;
+      break;
+
+    case STAGE_RELEASE:
+      if (voice.level <= s_releaseStep)
+      {
+        voice.level = 0;
+        voice.stage = STAGE_IDLE;
+        stopIfSilent();
+      }
+      else voice.level -= s_releaseStep;
+      break;
+
+    default:
+      return;
+  }
+  voice.amplitude = (static_cast<uint16_t> (voice.level >> 8) * voiceGain) >> 8;
+}
+
+//
+// clipStep
+//
+// Decodes the clip's next sample
+//
+
+inline void toneSynth::clipStep()
+{
+  if (--s_clipRemaining == 0)
+  {
+    // The last sample has had its turn
+    s_clipOut = 0;
+    stopIfSilent();
+    return;
+  }
+
+  uint8_t code = pgm_read_byte_near(s_pClip);
+  if (s_clipHighNibble)
+  {
+    code >>= 4;
+    s_pClip++;
+  }
+  s_clipHighNibble = !s_clipHighNibble;
+  code &= 0x0F;
+
+  uint16_t step = pgm_read_word_near(&stepTable[s_clipIndex]);
+  uint16_t diff = step >> 3;
+  if (code & 4) diff += step;
+  if (code & 2) diff += step >> 1;
+  if (code & 1) diff += step >> 2;
+
+  int32_t predictor = s_clipPredictor;
+  if (code & 8) predictor -= diff;
+  else predictor += diff;
+  if (predictor > 32767) predictor = 32767;
+  else if (predictor < -32768) predictor = -32768;
+  s_clipPredictor = predictor;
+
+  int8_t index = s_clipIndex + static_cast<int8_t> (pgm_read_byte_near(&indexTable[code & 7]));
+  s_clipIndex = (index < 0) ? 0 : (index > 88) ? 88 : index;
+
+  // Top 8 bits, offset to 0 - 255 like the waveform, at the same gain as a voice
+  s_clipOut = (static_cast<uint16_t> ((predictor >> 8) + 128) * voiceGain) >> 8;
+}
+
+// Sample handler.  Not an interrupt vector itself, the overflow interrupt below jumps to it.
+#ifdef __AVR__
+extern "C" void toneSynthSample(void) __attribute__((signal, used));
+#else
+extern "C" void toneSynthSample(void);
+#endif
+
+void toneSynthSample(void)
+{
+#ifdef PROFILE
+  uint16_t startCount = TCNT1;
+#endif
+
+  toneSynth::sample();
+
+#ifdef PROFILE
+  // A Servo frame starting part way through resets TCNT1; that one isn't counted
+  uint16_t endCount = TCNT1;
+  if (endCount >= startCount) busyCounts += (endCount - startCount) + isrEntryExitCounts;
+#endif
+}
+
+#ifdef __AVR__
+// Counts the overflow and returns on odd counts, saving only r24 and SREG.  On even counts
+// it puts those back and jumps to the sample handler which saves what it needs and returns
+// from the interrupt.
+ISR(TIMER2_OVF_vect, ISR_NAKED)
+{
+  asm volatile(
+    "push r24                 \n\t"
+    "in   r24, __SREG__       \n\t"
+    "push r24                 \n\t"
+    "lds  r24, %[count]       \n\t"
+    "inc  r24                 \n\t"
+    "sts  %[count], r24       \n\t"
+    "sbrs r24, 0              \n\t"
+    "rjmp 1f                  \n\t"
+    "pop  r24                 \n\t"
+    "out  __SREG__, r24       \n\t"
+    "pop  r24                 \n\t"
+    "reti                     \n\t"
+    "1:                       \n\t"
+    "pop  r24                 \n\t"
+    "out  __SREG__, r24       \n\t"
+    "pop  r24                 \n\t"
+    "jmp  toneSynthSample     \n\t"
+    :
+    : [count] "i" (&overflowCount)
+  );
+}
+#else
+ISR(TIMER2_OVF_vect)
+{
+  if (++overflowCount & 0x01) return;
+  toneSynthSample();
+}
+#endif
+
+//
+// setup
+//
+
+void toneSynth::setup()
+{
+  pinMode(speakerPin, OUTPUT);
+  digitalWrite(speakerPin, LOW);
+
+  // Phase correct PWM, no prescaler.  The output stays disconnected until a note starts.
+  noInterrupts();
+  TIMSK2 &= ~bit(TOIE2);
+  TCCR2A = bit(WGM20);
+  TCCR2B = bit(CS20);
+  OCR2B = 0;
+  interrupts();
+
+  // A short attack and release soften the start and end of each note without blurring 
+  // quick passages
+  setEnvelope(5, 80, 160, 30);
+
+#ifdef PROFILE
+  windowStartUs = micros();
+#endif
+}
+
+//
+// setEnvelope
+//
+// Attack, decay and release are the time (ms) to rise from 0 to full, fall from full to the
+// sustain level and fall from full to 0.  sustainLevel is 0 - 255 of full.  Applies to all
+// of the voices.
+//
+
+void toneSynth::setEnvelope(uint8_t attackMs, uint8_t decayMs, uint8_t sustainLevel, uint8_t releaseMs)
+{
+  uint16_t sustain = sustainLevel * 257;
+  uint16_t attackStep = 0xFFFF/(attackMs ? attackMs : 1);
+  uint16_t decayStep = (0xFFFF - sustain)/(decayMs ? decayMs : 1);
+  uint16_t releaseStep = 0xFFFF/(releaseMs ? releaseMs : 1);
+
+  noInterrupts();
+  s_attackStep = attackStep;
+  s_decayStep = decayStep ? decayStep : 1;
+  s_sustainLevel = sustain;
+  s_releaseStep = releaseStep;
+  interrupts();
+}
+
+//
+// claimVoice
+//
+// Returns a free voice, or noVoice if they are all in use
+//
+
+uint8_t toneSynth::claimVoice()
+{
+  for (uint8_t i = 0; i < numVoices; i++)
+  {
+    if (!(s_claimed & bit(i)))
+    {
+      s_claimed |= bit(i);
+      return i;
+    }
+  }
+  return noVoice;
+}
+
+//
+// freeVoice
+//
+// Gives a voice back.  A note still releasing carries on until it's done or the voice is
+// claimed and played again.
+//
+
+void toneSynth::freeVoice(uint8_t voice)
+{
+  s_claimed &= ~bit(voice);
+}
+
+//
+// noteOn
+//
+// Starts a note (a MIDI note number, see PITCH_XXX in action.h) or changes the pitch of 
+// the one sounding.  The attack starts from the current level and the phase carries on so
+// going from one note to the next doesn't click.
+//
+
+void toneSynth::noteOn(uint8_t voice, uint8_t note)
+{
+  uint16_t phaseStep = pgm_read_word_near(&noteStepTable[note & (numNotes - 1)]);
+
+  noInterrupts();
+  s_voices[voice].phaseStep = phaseStep;
+  s_voices[voice].stage = STAGE_ATTACK;
+  start();
+  interrupts();
+}
+
+//
+// noteOff
+//
+// Lets the voice's note die away over the release time
+//
+
+void toneSynth::noteOff(uint8_t voice)
+{
+  noInterrupts();
+  if (s_voices[voice].stage != STAGE_IDLE) s_voices[voice].stage = STAGE_RELEASE;
+  interrupts();
+}
+
+//
+// silence
+//
+// Stops the voice immediately
+//
+
+void toneSynth::silence(uint8_t voice)
+{
+  noInterrupts();
+  s_voices[voice].level = 0;
+  s_voices[voice].amplitude = 0;
+  s_voices[voice].stage = STAGE_IDLE;
+  stopIfSilent();
+  interrupts();
+}
+
+//
+// isSounding
+//
+// Returns true until the release of the voice's last note has finished
+//
+
+bool toneSynth::isSounding(uint8_t voice)
+{
+  return s_voices[voice].stage != STAGE_IDLE;
+}
+
+//
+// playClip
+//
+// Starts playing a clip (a clipId, see clips.h), cutting off any clip still playing.  
+// Returns how long it plays for (ms).
+//
+
+uint16_t toneSynth::playClip(uint8_t clip)
+{
+  adpcmClip entry;
+  memcpy_P(&entry, &adpcmClipTable[clip], sizeof(entry));
+
+  noInterrupts();
+  s_pClip = entry.pData;
+  s_clipRemaining = entry.numSamples + 1;
+  s_clipPredictor = 0;
+  s_clipIndex = 0;
+  s_clipHighNibble = false;
+  s_clipOut = (128 * voiceGain) >> 8;
+  start();
+  interrupts();
+
+  return (static_cast<uint32_t> (entry.numSamples) * 1000 + clipRateHz - 1) / clipRateHz;
+}
+
+//
+// stopClip
+//
+
+void toneSynth::stopClip()
+{
+  noInterrupts();
+  s_clipRemaining = 0;
+  s_clipOut = 0;
+  stopIfSilent();
+  interrupts();
+}
+
+//
+// start
+//
+// Connects the output and starts the interrupt if they aren't already.  Called with 
+// interrupts disabled.
+//
+
+void toneSynth::start()
+{
+  if (!(TIMSK2 & bit(TOIE2)))
+  {
+    TCCR2A |= bit(COM2B1);
+    TIFR2 = bit(TOV2);
+    TIMSK2 |= bit(TOIE2);
+  }
+}
+
+//
+// stopIfSilent
+//
+// Once no voice is sounding and no clip is playing, disconnects the output (the pin is left low) and stops the
+// interrupt.  Called with interrupts disabled.
+//
+
+void toneSynth::stopIfSilent()
+{
+  if (s_clipRemaining) return;
+  for (uint8_t i = 0; i < numVoices; i++)
+  {
+    if (s_voices[i].stage != STAGE_IDLE) return;
+  }
+  TCCR2A &= ~bit(COM2B1);
+  TIMSK2 &= ~bit(TOIE2);
+  OCR2B = 0;
+}
+
+//
+// getCpuPermille
+//
+// Returns the time spent in the interrupt, in parts per thousand, since the last call and
+// starts a new measurement window.  Only measured when PROFILE is defined, otherwise 0.
+//
+
+uint16_t toneSynth::getCpuPermille()
+{
+#ifdef PROFILE
+  uint32_t nowUs = micros();
+  uint32_t windowUs = nowUs - windowStartUs;
+  uint32_t busyUs;
+
+  noInterrupts();
+  busyUs = busyCounts >> 1;
+  busyCounts = 0;
+  interrupts();
+  windowStartUs = nowUs;
+
+  // Scale both down to keep the multiply from overflowing on long windows
+  return static_cast<uint16_t> (((busyUs >> 8) * 1000) / ((windowUs >> 8) + 1));
+#else
+  return 0;
+#endif
+}
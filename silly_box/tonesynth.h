@@ -0,0 +1,139 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// toneSynth class generates the speaker's sound by direct digital synthesis (DDS) from a
+// Timer2 interrupt: up to 3 voices, each shaped by an attack/decay/sustain/release (ADSR)
+// envelope, mixed into one PWM output.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// Timer2 runs 8 bit phase correct PWM on OC2B (pin 3) with no prescaler, a 31.4kHz carrier
+// the speaker can't follow.  Every other Timer2 overflow the interrupt makes one sample
+// (sample()), a 15.7kHz sample rate.  For each voice that is sounding it advances a 16 bit phase 
+// accumulator, looks the phase up in a waveform table and scales it by the voice's 
+// amplitude.  The voices are summed and the sum clipped to the 8 bit duty cycle.
+//
+// Each voice has its own attack/decay/sustain/release envelope, stepped about once a 
+// millisecond.  The envelope steps are spread over the samples, one voice per sample, and 
+// also work out the voice's amplitude: its level scaled by voiceGain so that one voice alone
+// doesn't use the whole output and two voices at the sustain level don't clip (two at the
+// peak of their attack do, briefly).
+//
+// Voices are claimed by whoever wants to play (each soundSequence claims one).  The 
+// interrupt only runs while a voice sounds or releases or a clip plays.
+//
+// On top of the voices one recorded clip at a time can play (SEQ_PLAY_SAMPLE).  Clips are
+// 4 bit IMA-ADPCM, a quarter the size of 8 bit samples, decoded one sample at a time in the
+// interrupt at half the sample rate (clipRateHz, 7.8kHz).
+//
+
+// An IMA-ADPCM clip in PROGMEM: two 4 bit codes per byte, low nibble first, decoded from a
+// predictor and step index of 0.  tools/adpcm_encode.py makes them from WAV files.
+struct adpcmClip
+{
+  uint16_t numSamples;
+  const uint8_t* pData;
+};
+
+// Clips played by SEQ_PLAY_SAMPLE, indexed by clipId (clips.cpp, generated)
+extern const adpcmClip adpcmClipTable[] PROGMEM;
+
+class toneSynth
+{
+  public:
+    static const int speakerPin = 3;  // OC2B
+    static const uint16_t sampleRateHz = F_CPU/510/2;
+    static const uint8_t numVoices = 3;
+    static const uint8_t noVoice = 0xFF;
+    static const uint16_t clipRateHz = sampleRateHz/2;
+    static const uint8_t numNotes = 128;   // MIDI note numbers, see PITCH_XXX in action.h
+
+  private:
+    static const uint8_t envelopeSamples = 16;
+    static const uint8_t voiceGain = 171;  // 2/3, 8 bit fraction
+
+    enum envelopeStage
+    {
+      STAGE_IDLE,
+      STAGE_ATTACK,
+      STAGE_DECAY,
+      STAGE_SUSTAIN,
+      STAGE_RELEASE
+    };
+
+    struct voiceState
+    {
+      uint16_t phase;
+      uint16_t phaseStep;        // frequency, in 1/65536ths of a cycle per sample
+      uint16_t level;            // envelope, 0 - 0xFFFF
+      uint8_t amplitude;         // level scaled by voiceGain, what the sample is scaled by
+      volatile uint8_t stage;
+    };
+
+    static const uint8_t waveTable[256] PROGMEM;
+    static const uint16_t noteStepTable[numNotes] PROGMEM;   // phase step of each note
+    static const uint16_t stepTable[89] PROGMEM;   // IMA-ADPCM step sizes
+    static const int8_t indexTable[8] PROGMEM;     // IMA-ADPCM step index changes
+
+  // Methods
+  public:
+    static void setup();
+    static void setEnvelope(uint8_t attackMs, uint8_t decayMs, uint8_t sustainLevel, uint8_t releaseMs);
+    static uint8_t claimVoice();
+    static void freeVoice(uint8_t voice);
+    static void noteOn(uint8_t voice, uint8_t note);
+    static void noteOff(uint8_t voice);
+    static void silence(uint8_t voice);
+    static bool isSounding(uint8_t voice);
+    static uint16_t playClip(uint8_t clip);
+    static void stopClip();
+    static uint16_t getCpuPermille();
+    static inline void sample() __attribute__((always_inline));
+
+  private:
+    static inline void envelopeStep(voiceState& voice) __attribute__((always_inline));
+    static inline void clipStep() __attribute__((always_inline));
+    static void start();
+    static void stopIfSilent();
+
+  // Attributes
+  private:
+    static voiceState s_voices[numVoices];
+    static uint8_t s_claimed;               // one bit per voice
+
+    // Clip being played
+    static const uint8_t* s_pClip;          // next code
+    static uint16_t s_clipRemaining;        // samples + 1, 0 when no clip is playing
+    static int16_t s_clipPredictor;
+    static uint8_t s_clipIndex;
+    static bool s_clipHighNibble;
+    static uint8_t s_clipOut;               // the clip's part of the mix
+
+    // Envelope, as level change per envelope step (about 1ms)
+    static uint16_t s_attackStep;
+    static uint16_t s_decayStep;
+    static uint16_t s_sustainLevel;
+    static uint16_t s_releaseStep;
+};
@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the trace class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "trace.h"
+
+uint8_t trace::s_buffer[bufferSize];
+uint8_t trace::s_head = 0;
+uint8_t trace::s_tail = 0;
+uint8_t trace::s_lost = 0;
+
+static_assert((trace::bufferSize & (trace::bufferSize - 1)) == 0 && trace::bufferSize <= 128, 
+              "trace::bufferSize must be a power of 2 no more than 128");
+
+void trace::setup()
+{
+  // Forget anything logged by the sequences' constructors, the log starts here
+  s_head = s_tail = 0;
+  s_lost = 0;
+
+  Serial.begin(baudRate);
+  log(TR_BOOT);
+}
+
+//
+// drain
+//
+// Hands the serial port as much of the log as its transmit buffer has room for.  Never 
+// waits.
+//
+
+void trace::drain()
+{
+  uint8_t count = s_head - s_tail;
+  int room = Serial.availableForWrite();
+
+  if (room < count) count = room;
+  while (count-- > 0)
+  {
+    Serial.write(s_buffer[s_tail++ & (bufferSize - 1)]);
+  }
+}
+
+//
+// start
+//
+// Makes room for a message of 'argBytes' bytes of arguments and writes its ID.  Returns 
+// false, and counts the message as lost, if there isn't room.
+//
+
+bool trace::start(traceId id, uint8_t argBytes)
+{
+  if (!hasRoom(1 + argBytes))
+  {
+    if (s_lost < 255) s_lost++;
+    return false;
+  }
+
+  // Messages were lost before this one, say so first
+  if (s_lost != 0)
+  {
+    put(TR_LOST);
+    put(s_lost);
+    s_lost = 0;
+  }
+  put(id);
+  return true;
+}
+
+void trace::log(traceId id)
+{
+  start(id, 0);
+}
+
+void trace::log(traceId id, uint8_t arg)
+{
+  if (start(id, 1)) put(arg);
+}
+
+void trace::log(traceId id, uint16_t arg1, uint16_t arg2, uint16_t arg3)
+{
+  if (!start(id, 6)) return;
+  put16(arg1);
+  put16(arg2);
+  put16(arg3);
+}
+
+void trace::log(traceId id, uint32_t arg1, int16_t arg2)
+{
+  if (!start(id, 6)) return;
+  put16(arg1);
+  put16(arg1 >> 16);
+  put16(arg2);
+}
+
+void trace::log(traceId id, const uint8_t* pData, uint8_t length)
+{
+  if (!start(id, length)) return;
+  while (length-- > 0) put(*pData++);
+}
+
+void trace::log(traceId id, uint8_t arg, const uint8_t* pData, uint8_t length)
+{
+  if (!start(id, 1 + length)) return;
+  put(arg);
+  while (length-- > 0) put(*pData++);
+}
+
+//
+// hasRoom
+//
+// Returns true if a message of 'messageBytes' bytes (ID and arguments) would be logged 
+// rather than lost.  For messages that had better not be lost, which can wait for room.
+//
+
+bool trace::hasRoom(uint8_t messageBytes)
+{
+  uint8_t room = bufferSize - static_cast<uint8_t> (s_head - s_tail);
+  if (s_lost != 0) messageBytes += 2;
+  return room >= messageBytes;
+}
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// trace class keeps a log of what the sketch is doing and sends it out of the serial port 
+// when there is time to.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+// Define preprocessor TRACE in a file (before its #includes) to log its Trace() calls.
+//
+//   Trace(TR_START_SWITCH_GROUP, static_cast<uint8_t> (switchGroupIndex));
+//
+// The message and the types of its arguments are listed in tracemsgs.h.  Run the serial
+// port through tools/trace_decode.py to read the log.
+
+#ifdef TRACE
+  #define Trace(...) trace::log(__VA_ARGS__)
+#else
+  #define Trace(...)
+#endif
+
+enum traceId : uint8_t
+{
+#define TRACE_MSG(_ID, _TEXT) _ID,
+#include "tracemsgs.h"
+#undef TRACE_MSG
+  NUM_TRACE_IDS
+};
+
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// !!                                                                                        !!
+// !! Why not Serial.print()?                                                                !!
+// !!                                                                                        !!
+// !! At 115200 baud a character takes 87us and Serial has a 64 byte transmit buffer.  A     !!
+// !! few messages of text fill it and then Serial.print() waits for room, for milliseconds  !!
+// !! in the middle of a move.  Here a message is its one byte ID and its arguments in       !!
+// !! binary (1 to 7 bytes), copied into a RAM buffer in a few microseconds.  drain() is     !!
+// !! called at the end of loop(), before it sleeps, and only hands Serial as many bytes as  !!
+// !! it has room for so it never waits.  If the buffer fills, messages are dropped whole    !!
+// !! and counted and the count is logged (TR_LOST) once there is room again.                !!
+// !!                                                                                        !!
+// !! The log is only decoded if the decoder sees it from the start (TR_BOOT).  Opening the  !!
+// !! port on a Nano resets it, so that is the normal case.                                  !!
+// !!                                                                                        !!
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+class trace
+{
+  public:
+    static const uint32_t baudRate = 115200;
+    static const uint8_t bufferSize = 64;  // power of 2, no more than 128
+
+  // Methods.  Not for interrupt handlers.
+  public:
+    static void setup();
+    static void drain();
+    static void log(traceId id);
+    static void log(traceId id, uint8_t arg);
+    static void log(traceId id, uint16_t arg1, uint16_t arg2, uint16_t arg3);
+    static void log(traceId id, uint32_t arg1, int16_t arg2);
+    static void log(traceId id, const uint8_t* pData, uint8_t length);
+    static void log(traceId id, uint8_t arg, const uint8_t* pData, uint8_t length);
+    static bool hasRoom(uint8_t messageBytes);
+
+  private:
+    static bool start(traceId id, uint8_t argBytes);
+    static void put(uint8_t byte) { s_buffer[s_head++ & (bufferSize - 1)] = byte; }
+    static void put16(uint16_t word) { put(word); put(word >> 8); }
+
+  // Attributes
+  private:
+    static uint8_t s_buffer[bufferSize];
+    static uint8_t s_head;    // count of bytes written, wraps
+    static uint8_t s_tail;    // count of bytes sent, wraps
+    static uint8_t s_lost;    // messages dropped since the last TR_LOST
+};
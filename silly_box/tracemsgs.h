@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Trace messages.  Each one is logged as its one byte ID followed by its arguments (see
+// trace.h); the text is only used by tools/trace_decode.py to print it again.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// No #pragma once, this list is included once for each use of TRACE_MSG.
+//
+// TRACE_MSG(ID, "text").  Arguments are shown in the text where they are printed, in the
+// order they are passed to trace::log() and with the type they are passed as:
+//
+//   {u8} uint8_t    {u16} uint16_t    {i16} int16_t    {u32} uint32_t
+//   {action} uint8_t printed as its ACTION_XXX name (see action.h)
+//   {hist} reactionTimer::numBuckets uint8_t counts, printed with their percentiles
+//   {section} uint8_t printed as its PROF_XXX name (see profiler.h)
+//   {prof} a profiler row, printed as calls and cycles
+//
+// Add new messages at the end so logs from older builds still decode.
+
+TRACE_MSG(TR_BOOT,                  "Silly Box started")
+TRACE_MSG(TR_LOST,                  "({u8} trace messages lost, the buffer was full)")
+TRACE_MSG(TR_SETUP_COMPLETE,        "Setup Complete")
+TRACE_MSG(TR_TEST_MODE,             "********** ENTERING TEST MODE ************")
+TRACE_MSG(TR_START_PROX_GROUP,      "Start Prox Group {u8}")
+TRACE_MSG(TR_START_SWITCH_STATE,    "SILLY_START_SWITCH_GROUP")
+TRACE_MSG(TR_START_SWITCH_GROUP,    "Start Switch Group {u8}")
+TRACE_MSG(TR_SWITCH_GROUP_COMPLETE, "Switch Group Complete")
+TRACE_MSG(TR_PROX_GROUP_COMPLETE,   "Prox Group Complete")
+TRACE_MSG(TR_BAD_STATE,             "ERROR: Invalid sillyState value!!! Resetting to idle state...")
+TRACE_MSG(TR_CPU_LOAD,              "Awake (per mille): {u16}  LED PWM (per mille): {u16}  Tone DDS (per mille): {u16}")
+TRACE_MSG(TR_GROUP_TIME,            "Group time (ms): {u32}  late (ms): {i16}")
+TRACE_MSG(TR_MOVE_ACTION,           "{action}")
+TRACE_MSG(TR_APPROACHING,           "Approaching switch...")
+TRACE_MSG(TR_PROX_ALERT,            "--- issuing proximity alert ---")
+TRACE_MSG(TR_PROX_IGNORED,          "ignoring approach")
+TRACE_MSG(TR_REACTION_START,        "Switch to group start: {hist}")
+TRACE_MSG(TR_REACTION_SERVO,        "Group {u8} switch to first servo write: {hist}")
+TRACE_MSG(TR_REACTION_STRIKE,       "Group {u8} switch to strike: {hist}")
+TRACE_MSG(TR_PROFILE_ACTION,        "{action} {prof}")
+TRACE_MSG(TR_PROFILE_SECTION,       "{section} {prof}")
+TRACE_MSG(TR_PROFILE_SKIPPED,       "({u16} measurements spanned a Timer1 reset and were skipped)")
+TRACE_MSG(TR_STACK,                 "Variables: {u16}  Stack never reached: {u16}  Free now: {u16}")
+TRACE_MSG(TR_VM_OVERFLOW,           "ERROR: {action} nested deeper than sequence::vmStackDepth, sequence stopped")
+TRACE_MSG(TR_VM_RUNAWAY,            "ERROR: {action} ended sequence::maxFlowSteps flow control actions in a row, sequence stopped")
@@ -0,0 +1,213 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation for the ws2812Strip class
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ws2812.h"
+#include "color.h"
+#include "movesequence.h"
+
+// The data pin as a port and bit for the bit banging code.  A0 is bit 0 of port C.
+#define STRIP_PORT PORTC
+#define STRIP_BIT  0
+
+uint8_t ws2812Strip::s_grb[numPixels*3];
+uint8_t ws2812Strip::s_sendCount = 0;
+uint32_t ws2812Strip::s_frameEndUs = 0;
+#ifndef __AVR__
+void (*ws2812Strip::s_pMockWire)(uint8_t highCycles, uint8_t totalCycles) = NULL;
+#endif
+
+#define CYCLES_TO_NS(_CYCLES) ((_CYCLES)*1000UL/(F_CPU/1000000UL))
+
+void ws2812Strip::setup()
+{
+  pinMode(stripPin, OUTPUT);
+  digitalWrite(stripPin, LOW);
+
+  // The bit timing must be within the WS2812B's tolerances: 0 high 400ns +/- 150ns, 1 high 
+  // 800ns +/- 150ns, bit 1250ns +/- 600ns
+  static_assert(CYCLES_TO_NS(t0hCycles) >= 250 && CYCLES_TO_NS(t0hCycles) <= 550, "ws2812 0 bit high time out of range");
+  static_assert(CYCLES_TO_NS(t1hCycles) >= 650 && CYCLES_TO_NS(t1hCycles) <= 950, "ws2812 1 bit high time out of range");
+  static_assert(CYCLES_TO_NS(bitCycles) >= 650 && CYCLES_TO_NS(bitCycles) <= 1850, "ws2812 bit time out of range");
+
+  // Send the whole (blank) frame first to clear whatever the strip was showing
+  s_sendCount = numPixels;
+  s_frameEndUs = micros();
+}
+
+uint32_t ws2812Strip::getPixel(uint8_t pixel)
+{
+  const uint8_t* pGrb = &s_grb[pixel*3];
+  return RGB(pGrb[1], pGrb[0], pGrb[2]);
+}
+
+//
+// setPixel
+//
+// Changes a pixel in the frame buffer.  It is sent by the next flush() if it is a change.
+//
+
+void ws2812Strip::setPixel(uint8_t pixel, uint32_t color)
+{
+  uint8_t* pGrb = &s_grb[pixel*3];
+  uint8_t r = color >> 16;
+  uint8_t g = color >> 8;
+  uint8_t b = color;
+
+  if (pGrb[0] == g && pGrb[1] == r && pGrb[2] == b) return;
+
+  pGrb[0] = g;
+  pGrb[1] = r;
+  pGrb[2] = b;
+  if (pixel >= s_sendCount) s_sendCount = pixel + 1;
+}
+
+//
+// flush
+//
+// Sends the changed part of the frame buffer to the strip, through the gamma table.  
+// Returns false if it has to wait (for the strip to latch the last frame or for a gap in
+// the servo pulses) in which case it should be called again soon.  Call at most once each
+// time loop() is executed so all of the changes made in one pass go out as one frame.
+//
+
+bool ws2812Strip::flush()
+{
+  if (s_sendCount == 0) return true;
+
+  // The strip needs to see the data line low for the latch time between frames
+  if (micros() - s_frameEndUs < latchUs) return false;
+
+#ifndef SERVO_PCA9685
+  // Wait for a gap between the Servo library's interrupts that the whole transfer fits in.
+  // The library runs Timer1 at 0.5us per count and OCR1A holds the count at which its next
+  // interrupt is due.  (Servos on a PCA9685 have no interrupts to dodge.)
+  uint16_t servoCounts;
+  bool servoPending;
+  noInterrupts();
+  servoCounts = OCR1A - TCNT1;
+  servoPending = (TIFR1 & bit(OCF1A)) != 0;
+  interrupts();
+  if (servoPending || servoCounts < 2*(s_sendCount*pixelUs + servoMarginUs)) return false;
+#endif
+
+  const uint8_t* pPixel = s_grb;
+  uint8_t grb[3];
+  uint8_t pixelEndCount = 0;
+
+  for (uint8_t i = 0; i < s_sendCount; i++)
+  {
+    for (uint8_t j = 0; j < 3; j++)
+    {
+      grb[j] = pgm_read_byte_near(&gammaTable[*pPixel++]);
+    }
+
+    noInterrupts();
+    // Timer0 counts 4us.  If an interrupt in the last gap took so long that the strip has 
+    // latched the pixels sent so far, start over later.
+    if (i > 0 && static_cast<uint8_t> (TCNT0 - pixelEndCount) > maxGapUs/4)
+    {
+      interrupts();
+      s_frameEndUs = micros();
+      return false;
+    }
+    sendPixel(grb);
+    pixelEndCount = TCNT0;
+    interrupts();
+  }
+
+  s_sendCount = 0;
+  s_frameEndUs = micros();
+  return true;
+}
+
+//
+// sendPixel
+//
+// Sends the 24 bits of one pixel, most significant bit first.  MUST be called with
+// interrupts disabled.  Each bit goes high, drops after t0hCycles if it is a 0 or after
+// t1hCycles if it is a 1 and the next bit starts bitCycles after this one.  The padding 
+// between instructions is worked out from those so the timing stays as specified:
+//
+//   t = 0               out hi                  start of bit
+//   t = 1               padA nops
+//   t = padA + 1        sbrs (skips the out for a 1, 2 cycles)
+//   t = padA + 2        out lo                  end of a 0 (t0hCycles)
+//   t = padA + 3        lsl
+//   t = padA + 4        padB nops
+//   t = t1hCycles       out lo                  end of a 1
+//   t = t1hCycles + 1   padC nops, dec, brne (2 cycles taken)
+//   t = bitCycles       out hi                  start of the next bit
+//
+// The low time between bytes is a few cycles longer, which the strip doesn't mind.
+//
+
+void ws2812Strip::sendPixel(const uint8_t* pGrb)
+{
+#ifdef __AVR__
+  uint8_t hi = STRIP_PORT | bit(STRIP_BIT);
+  uint8_t lo = STRIP_PORT & ~bit(STRIP_BIT);
+  uint8_t count = 3;
+  uint8_t byte;
+  uint8_t bits;
+
+  asm volatile(
+    "1:                     \n\t"
+    "ld   %[byte], %a[ptr]+ \n\t"
+    "ldi  %[bits], 8        \n\t"
+    "2:                     \n\t"
+    "out  %[port], %[hi]    \n\t"
+    ".rept %[padA]          \n\t"
+    "nop                    \n\t"
+    ".endr                  \n\t"
+    "sbrs %[byte], 7        \n\t"
+    "out  %[port], %[lo]    \n\t"
+    "lsl  %[byte]           \n\t"
+    ".rept %[padB]          \n\t"
+    "nop                    \n\t"
+    ".endr                  \n\t"
+    "out  %[port], %[lo]    \n\t"
+    ".rept %[padC]          \n\t"
+    "nop                    \n\t"
+    ".endr                  \n\t"
+    "dec  %[bits]           \n\t"
+    "brne 2b                \n\t"
+    "dec  %[count]          \n\t"
+    "brne 1b                \n\t"
+    : [byte] "=&r" (byte), [bits] "=&d" (bits), [count] "+r" (count), [ptr] "+e" (pGrb)
+    : [port] "I" (_SFR_IO_ADDR(STRIP_PORT)), [hi] "r" (hi), [lo] "r" (lo),
+      [padA] "I" (t0hCycles - 2), [padB] "I" (t1hCycles - t0hCycles - 2), 
+      [padC] "I" (bitCycles - t1hCycles - 4)
+  );
+#else
+  if (s_pMockWire == NULL) return;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    for (uint8_t mask = 0x80; mask != 0; mask >>= 1)
+    {
+      s_pMockWire((pGrb[i] & mask) ? t1hCycles : t0hCycles, bitCycles);
+    }
+  }
+#endif
+}
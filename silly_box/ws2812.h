@@ -0,0 +1,83 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ws2812Strip class drives a strip of WS2812 (NeoPixel) addressable RGB LEDs.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Arduino.h"
+
+//
+// LED hardware for ledSequence (see ledsequence.h).  setPixel() only changes the frame 
+// buffer; flush() sends it to the strip.  The strip takes its data as one continuous 800kHz 
+// bit stream starting at the first pixel, so flush() sends every pixel up to the last one
+// that changed and nothing at all when none have.
+//
+// The bits are timed by counting CPU cycles so interrupts are held off while each pixel 
+// (30us) is sent.  To keep that from disturbing the servo pulses, flush() waits for a gap
+// in them long enough for the whole transfer.  Interrupts are let in between pixels so 
+// millis() keeps time on long strips.
+//
+
+class ws2812Strip
+{
+  public:
+    static const uint8_t numPixels = 30;
+
+    // Bit timing in CPU cycles (62.5ns at 16MHz).  The bit is high for t0hCycles for a 0 and
+    // t1hCycles for a 1.
+    static const uint8_t t0hCycles = 6;
+    static const uint8_t t1hCycles = 13;
+    static const uint8_t bitCycles = 20;
+
+  private:
+    static const int stripPin = A0;                // MUST match STRIP_PORT/STRIP_BIT in ws2812.cpp
+
+    static const uint8_t pixelUs = 32;             // 24 bits plus the work in between
+    static const uint8_t servoMarginUs = 20;       // leeway around the servo interrupt
+    static const uint8_t maxGapUs = 40;            // the strip latches after 50us low
+    static const uint16_t latchUs = 300;           // low time that ends a frame (WS2812B)
+
+  // Methods
+  public:
+    static void setup();
+    static uint32_t getPixel(uint8_t pixel);
+    static void setPixel(uint8_t pixel, uint32_t color);
+    static bool flush();
+
+  private:
+    static void sendPixel(const uint8_t* pGrb);
+
+  // Attributes
+  private:
+    static uint8_t s_grb[numPixels*3];             // frame buffer, 3 bytes per pixel in the strip's order
+    static uint8_t s_sendCount;                    // pixels that need sending, 0 when the strip is up to date
+    static uint32_t s_frameEndUs;                  // when the last transfer ended
+
+#ifndef __AVR__
+  public:
+    // Builds for other processors (i.e. on a PC) can't time the bits.  Instead, if this is 
+    // set, each bit is handed to it as the number of cycles it would be high and its total 
+    // number of cycles so the waveform can be checked.
+    static void (*s_pMockWire)(uint8_t highCycles, uint8_t totalCycles);
+#endif
+};
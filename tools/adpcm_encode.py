@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+#############################################################################################
+#
+# adpcm_encode.py - converts WAV files to the 4 bit IMA-ADPCM clips played by
+# SEQ_PLAY_SAMPLE (see toneSynth in silly_box/tonesynth.cpp).
+#
+#   adpcm_encode.py [--verify] [--gain G] -o silly_box/clips grumble.wav hey.wav ...
+#   adpcm_encode.py --played played.bin sounds/*.wav
+#
+# writes silly_box/clips.h and silly_box/clips.cpp with one clip per WAV file, named after
+# the file (grumble.wav is CLIP_GRUMBLE).  The WAV files can be any rate, 8 or 16 bit, mono
+# or stereo; they are mixed to mono and resampled to the rate the sketch plays clips at.
+#
+# --verify decodes each clip the same way the sketch does and compares it with the
+# resampled source, printing the signal to noise ratio and the largest error in 8 bit
+# output steps.  It fails (exit status 1) if a clip comes out worse than --min-snr.
+#
+# --played does the same with what the sketch's own decoder played, as written by the host
+# build's silly_box_clipcheck (one output byte per sample, the clips one after another).
+# Those have to match this script's decoder step for step as well.
+#
+#############################################################################################
+
+#############################################################################################
+#
+#  Copyright 2021, Todd W. Lumpkin
+#
+#  This file is part of the "Silly Box" program.
+#
+#  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+#  of the GNU General Public License as published by the Free Software Foundation, 
+#  version 3 of the License.
+#
+#  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+#  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#  See the GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License along with "Silly Box" 
+#  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+#
+#############################################################################################
+
+import argparse
+import math
+import os
+import struct
+import sys
+import wave
+
+# Must match toneSynth::clipRateHz: F_CPU/510/2 samples per second, every other sample
+F_CPU = 16000000
+CLIP_RATE_HZ = F_CPU // 510 // 2 // 2
+
+# IMA-ADPCM tables, the same as toneSynth's
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279,
+    307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411,
+    1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+    20350, 22385, 24623, 27086, 29794, 32767
+]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+# Must match toneSynth::voiceGain, which a clip is played at
+VOICE_GAIN = 171
+
+
+class Decoder:
+    """Decoder state, step for step what the sketch's interrupt does"""
+
+    def __init__(self):
+        self.predictor = 0
+        self.index = 0
+
+    def decode(self, code):
+        step = STEP_TABLE[self.index]
+        diff = step >> 3
+        if code & 4:
+            diff += step
+        if code & 2:
+            diff += step >> 1
+        if code & 1:
+            diff += step >> 2
+        if code & 8:
+            self.predictor = max(-32768, self.predictor - diff)
+        else:
+            self.predictor = min(32767, self.predictor + diff)
+        self.index = min(88, max(0, self.index + INDEX_TABLE[code & 7]))
+        return self.predictor
+
+
+def encode(samples):
+    """Encodes 16 bit samples, returning the 4 bit codes"""
+    decoder = Decoder()
+    codes = []
+    for sample in samples:
+        step = STEP_TABLE[decoder.index]
+        delta = sample - decoder.predictor
+        code = 0
+        if delta < 0:
+            code = 8
+            delta = -delta
+        if delta >= step:
+            code |= 4
+            delta -= step
+        if delta >= step >> 1:
+            code |= 2
+            delta -= step >> 1
+        if delta >= step >> 2:
+            code |= 1
+        decoder.decode(code)    # track exactly what the sketch will reconstruct
+        codes.append(code)
+    return codes
+
+
+def read_wav(path, gain):
+    """Returns the WAV file's samples, mono, 16 bit and at CLIP_RATE_HZ"""
+    with wave.open(path, 'rb') as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        frames = wav.readframes(wav.getnframes())
+
+    if width == 1:
+        values = [(b - 128) << 8 for b in frames]
+    elif width == 2:
+        values = list(struct.unpack('<%dh' % (len(frames) // 2), frames))
+    else:
+        sys.exit('%s: only 8 and 16 bit WAV files are supported' % path)
+    mono = [sum(values[i:i + channels]) / channels for i in range(0, len(values), channels)]
+
+    # Linear interpolation is plenty for voice clips going down to ~8kHz
+    count = int(len(mono) * CLIP_RATE_HZ / rate)
+    out = []
+    for i in range(count):
+        pos = i * rate / CLIP_RATE_HZ
+        j = int(pos)
+        frac = pos - j
+        nxt = mono[j + 1] if j + 1 < len(mono) else mono[j]
+        value = (mono[j] * (1 - frac) + nxt * frac) * gain
+        out.append(int(max(-32768, min(32767, round(value)))))
+    return out
+
+
+def verify(name, samples, codes, min_snr):
+    """Decodes the codes and compares them with the source samples"""
+    decoder = Decoder()
+    signal = noise = 0.0
+    worst = 0
+    for sample, code in zip(samples, codes):
+        decoded = decoder.decode(code)
+        signal += float(sample) * sample
+        noise += float(sample - decoded) ** 2
+        # The sketch only plays the top 8 bits
+        worst = max(worst, abs((sample >> 8) - (decoded >> 8)))
+    snr = 10 * math.log10(signal / noise) if noise else float('inf')
+    print('%s: %d samples, SNR %.1f dB, largest error %d of 255' % (name, len(samples), snr, worst))
+    return snr >= min_snr
+
+
+def output(value):
+    """The duty cycle (0 - 255) the sketch plays a 16 bit value at, as toneSynth::clipStep()"""
+    return (((value >> 8) + 128) * VOICE_GAIN) >> 8
+
+
+def verify_played(name, samples, codes, played, min_snr):
+    """Compares what the sketch played with the source samples and this script's decoder"""
+    if len(played) < len(codes):
+        print('%s: only %d of %d samples played' % (name, len(played), len(codes)))
+        return False
+    decoder = Decoder()
+    middle = 128 * VOICE_GAIN / 256
+    signal = noise = 0.0
+    worst = 0
+    mismatches = 0
+    for sample, code, out in zip(samples, codes, played):
+        expected = ((sample / 256) + 128) * VOICE_GAIN / 256
+        signal += (expected - middle) ** 2
+        noise += (expected - out) ** 2
+        worst = max(worst, abs(output(sample) - out))
+        if out != output(decoder.decode(code)):
+            mismatches += 1
+    snr = 10 * math.log10(signal / noise) if noise else float('inf')
+    print('%s: %d samples played, SNR %.1f dB, largest error %d of %d, %d differ from this '
+          'script\'s decoder' % (name, len(codes), snr, worst, output(32767), mismatches))
+    return snr >= min_snr and mismatches == 0
+
+
+def clip_name(path):
+    base = os.path.splitext(os.path.basename(path))[0]
+    words = ''.join(c if c.isalnum() else ' ' for c in base).split()
+    return 'CLIP_' + '_'.join(w.upper() for w in words), 'clip' + ''.join(w.capitalize() for w in words)
+
+
+LICENSE = '''/////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright 2021, Todd W. Lumpkin
+//
+//  This file is part of the "Silly Box" program.
+//
+//  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+//  of the GNU General Public License as published by the Free Software Foundation, 
+//  version 3 of the License.
+//
+//  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+//  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+//  See the GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along with "Silly Box" 
+//  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////
+'''
+
+
+def banner(text, sources):
+    rule = '/' * 93
+    return '%s\n//\n// %s\n//\n// Generated by tools/adpcm_encode.py from %s.  Don\'t edit, run it again.\n//\n%s\n\n' % (
+        rule, text, sources, rule)
+
+
+def write_sources(out, clips):
+    sources = ', '.join(os.path.basename(path) for path, _, _ in clips)
+    base = os.path.basename(out)
+
+    # CRLF, like the rest of the sketch
+    with open(out + '.h', 'w', newline='\r\n') as h:
+        h.write(banner('IMA-ADPCM voice clips for SEQ_PLAY_SAMPLE (see tonesynth.h)', sources))
+        h.write(LICENSE)
+        h.write('\n#pragma once\n#include "tonesynth.h"\n\nenum clipId\n{\n')
+        for path, _, _ in clips:
+            h.write('  %s,\n' % clip_name(path)[0])
+        h.write('  NUM_CLIPS\n};\n')
+
+    with open(out + '.cpp', 'w', newline='\r\n') as c:
+        c.write(banner('IMA-ADPCM voice clips for SEQ_PLAY_SAMPLE (see tonesynth.h)', sources))
+        c.write(LICENSE)
+        c.write('\n#include "%s.h"\n' % base)
+        for path, samples, codes in clips:
+            data = bytes((codes[i] | ((codes[i + 1] if i + 1 < len(codes) else 0) << 4))
+                         for i in range(0, len(codes), 2))
+            c.write('\n// %s: %d samples, %d ms\n' % (os.path.basename(path), len(codes),
+                                                    len(codes) * 1000 // CLIP_RATE_HZ))
+            c.write('static const uint8_t %s[] PROGMEM =\n{\n' % clip_name(path)[1])
+            for i in range(0, len(data), 16):
+                c.write('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',\n')
+            c.write('};\n')
+        c.write('\nconst adpcmClip adpcmClipTable[] PROGMEM =\n{\n')
+        for path, _, codes in clips:
+            c.write('  { %d, %s },\n' % (len(codes), clip_name(path)[1]))
+        c.write('};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert WAV files to IMA-ADPCM clips for the sketch')
+    parser.add_argument('wavs', nargs='+', help='WAV files, one clip each')
+    parser.add_argument('-o', '--out', help='output path without extension, e.g. silly_box/clips')
+    parser.add_argument('--gain', type=float, default=1.0, help='scale the samples by this')
+    parser.add_argument('--verify', action='store_true', help='decode and compare with the source')
+    parser.add_argument('--played', help='compare with the output of silly_box_clipcheck')
+    parser.add_argument('--min-snr', type=float, default=20.0, help='--verify and --played fail below this (dB)')
+    args = parser.parse_args()
+
+    played = None
+    if args.played:
+        with open(args.played, 'rb') as f:
+            played = f.read()
+
+    clips = []
+    ok = True
+    for path in args.wavs:
+        samples = read_wav(path, args.gain)
+        codes = encode(samples)
+        clips.append((path, samples, codes))
+        if args.verify:
+            ok = verify(os.path.basename(path), samples, codes, args.min_snr) and ok
+        if played is not None:
+            ok = verify_played(os.path.basename(path), samples, codes, played, args.min_snr) and ok
+            played = played[len(codes):]
+
+    if args.out:
+        write_sources(args.out, clips)
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,470 @@
+#!/usr/bin/env python3
+#############################################################################################
+#
+# midi_import.py - turns a melody in a Standard MIDI File into a sound sequence table
+# (SEQ_NOTE and SEQ_REST, see silly_box/action.h) for soundSequence.
+#
+#   midi_import.py --list jingle.mid
+#   midi_import.py [--track T] [--channel C] [--grid G] [--tempo BPM] [--articulate A]
+#                  [--name NAME] [-o silly_box/jingle.h] jingle.mid
+#
+# --list shows the tracks in the file.  Otherwise the notes of one track (the first one
+# with notes unless --track says) and optionally one channel are quantized to the NOTE_XXX
+# grid and written out as soundNameTbl[] with the songStyle it is played in.  A sound
+# sequence plays one note at a time, so where notes overlap the highest one is kept.
+# Leading silence is dropped and repeated runs of notes are folded into SEQ_LOOP/SEQ_NEXT.
+#
+# The flash the table takes and how far the quantized notes start from where the file has
+# them (including the rounding of songStyle's 32nd note to whole ms) are printed on stderr
+# and in the table's comment.  The output depends only on the file and the options so it
+# can be checked in and diffed.
+#
+#############################################################################################
+
+#############################################################################################
+#
+#  Copyright 2021, Todd W. Lumpkin
+#
+#  This file is part of the "Silly Box" program.
+#
+#  "Silly Box" is free software: you can redistribute it and/or modify it under the terms 
+#  of the GNU General Public License as published by the Free Software Foundation, 
+#  version 3 of the License.
+#
+#  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
+#  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#  See the GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License along with "Silly Box" 
+#  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+#
+#############################################################################################
+
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+
+ACTION_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'silly_box', 'action.h')
+
+# NOTE_XXX lengths in 32nd notes, longest first
+NOTE_NAMES = [
+    (32, 'NOTE_WHOLE'), (24, 'NOTE_DOT_HALF'), (16, 'NOTE_HALF'), (12, 'NOTE_DOT_QTR'),
+    (8, 'NOTE_QTR'), (6, 'NOTE_DOT_8TH'), (4, 'NOTE_8TH'), (3, 'NOTE_DOT_16TH'),
+    (2, 'NOTE_16TH'), (1, 'NOTE_32ND')
+]
+GRIDS = {'32nd': 1, '16th': 2, '8th': 4, 'qtr': 8}
+ARTICULATIONS = {'tenudo': 100, 'staccato': 80, 'legato': 95}
+TEMPO_NAMES = {200: 'TEMPO_PRESTO', 150: 'TEMPO_ALLEGRO', 125: 'TEMPO_MODERATO',
+               100: 'TEMPO_ANDANTE', 75: 'TEMPO_ADAGIO', 60: 'TEMPO_LARGHETTO', 40: 'TEMPO_LARGO'}
+
+# Bytes each action takes in the table (its operands, see actionFormat in sequence.cpp)
+NOTE_BYTES = 1 + 1 + 2 + 2
+REST_BYTES = 1 + 2
+LOOP_BYTES = 1 + 1
+NEXT_BYTES = 1
+END_BYTES = 1
+MAX_LOOP_EVENTS = 16
+
+
+#############################################################################################
+# R e a d i n g   t h e   f i l e
+#############################################################################################
+
+class Track:
+    def __init__(self, index):
+        self.index = index
+        self.name = ''
+        self.notes = []         # (start tick, end tick, channel, note number)
+        self.channels = set()
+
+
+def read_vlq(data, pos):
+    value = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value = (value << 7) | (byte & 0x7F)
+        if not byte & 0x80:
+            return value, pos
+
+
+def read_track(index, data, tempos, keys):
+    track = Track(index)
+    sounding = {}               # (channel, note) -> start tick
+    tick = 0
+    pos = 0
+    status = 0
+    while pos < len(data):
+        delta, pos = read_vlq(data, pos)
+        tick += delta
+        if data[pos] & 0x80:
+            status = data[pos]
+            pos += 1
+        elif status == 0 or status >= 0xF0:
+            raise ValueError('track %d: running status without a status byte' % index)
+
+        if status == 0xFF:
+            kind = data[pos]
+            length, pos = read_vlq(data, pos + 1)
+            body = data[pos:pos + length]
+            pos += length
+            if kind == 0x51 and length == 3:
+                tempos.append((tick, (body[0] << 16) | (body[1] << 8) | body[2]))
+            elif kind == 0x59 and length == 2:
+                keys.append((tick, struct.unpack('b', body[:1])[0]))
+            elif kind == 0x03 and not track.name:
+                track.name = body.decode('latin-1')
+            elif kind == 0x2F:
+                break
+            status = 0
+        elif status in (0xF0, 0xF7):
+            length, pos = read_vlq(data, pos)
+            pos += length
+            status = 0
+        else:
+            kind = status & 0xF0
+            channel = (status & 0x0F) + 1
+            if kind in (0xC0, 0xD0):
+                pos += 1
+                continue
+            note, velocity = data[pos], data[pos + 1]
+            pos += 2
+            if kind == 0x90 and velocity > 0:
+                # A note struck again before its note off ends the first one
+                if (channel, note) in sounding:
+                    track.notes.append((sounding[(channel, note)], tick, channel, note))
+                sounding[(channel, note)] = tick
+                track.channels.add(channel)
+            elif kind == 0x80 or kind == 0x90:
+                if (channel, note) in sounding:
+                    track.notes.append((sounding.pop((channel, note)), tick, channel, note))
+
+    for (channel, note), start in sorted(sounding.items()):
+        track.notes.append((start, tick, channel, note))
+    track.notes.sort()
+    return track
+
+
+def read_midi(path):
+    """Returns the ticks per quarter note, the tracks, the tempo map and the key signatures"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != b'MThd':
+        raise ValueError('not a Standard MIDI File')
+    length = struct.unpack('>I', data[4:8])[0]
+    _, count, division = struct.unpack('>HHH', data[8:14])
+    if division & 0x8000:
+        raise ValueError('SMPTE time division is not supported, save the file with beats')
+
+    tracks = []
+    tempos = []
+    keys = []
+    pos = 8 + length
+    while pos + 8 <= len(data) and len(tracks) < count:
+        kind = data[pos:pos + 4]
+        length = struct.unpack('>I', data[pos + 4:pos + 8])[0]
+        if kind == b'MTrk':
+            tracks.append(read_track(len(tracks), data[pos + 8:pos + 8 + length], tempos, keys))
+        pos += 8 + length
+
+    tempos.sort()
+    keys.sort()
+    return division, tracks, tempos, keys
+
+
+def tick_to_ms(tick, division, tempos):
+    """Where a tick falls in ms, following the tempo changes (120 BPM until the first)"""
+    ms = 0.0
+    last_tick = 0
+    us_per_qtr = 500000
+    for change_tick, change_us in tempos:
+        if change_tick >= tick:
+            break
+        ms += (change_tick - last_tick) * us_per_qtr / division / 1000.0
+        last_tick, us_per_qtr = change_tick, change_us
+    return ms + (tick - last_tick) * us_per_qtr / division / 1000.0
+
+
+#############################################################################################
+# Q u a n t i z i n g
+#############################################################################################
+
+def melody(notes):
+    """Reduces the notes to one at a time, keeping the highest where they start together"""
+    kept = []
+    dropped = 0
+    for start, end, _, note in sorted(notes, key=lambda n: (n[0], -n[3], n[1])):
+        if kept and kept[-1][0] == start:
+            dropped += 1
+            continue
+        kept.append((start, end, note))
+    return kept, dropped
+
+
+def quantize(notes, ticks_per_step, step, origin):
+    """
+    Rounds the notes to the grid and returns the events, ('note', number, 32nds, source
+    tick) and ('rest', None, 32nds, None), plus the number of notes that rounded onto the
+    one before them and were lost.
+    """
+    def grid(tick):
+        return int(math.floor((tick - origin) / ticks_per_step + 0.5)) * step
+
+    placed = []
+    merged = 0
+    for start, end, note in notes:
+        q_start = grid(start)
+        q_end = max(grid(end), q_start + step)
+        if placed and placed[-1][0] == q_start:
+            # Rounded onto the note before it; keep the higher one as melody() does
+            merged += 1
+            if note > placed[-1][2]:
+                placed[-1] = (q_start, q_end, note, start)
+            continue
+        placed.append((q_start, q_end, note, start))
+
+    events = []
+    for i, (q_start, q_end, note, start) in enumerate(placed):
+        if i + 1 < len(placed):
+            next_start = placed[i + 1][0]
+            q_end = min(q_end, next_start)
+        else:
+            next_start = q_end
+        events.append(('note', note, q_end - q_start, start))
+        if next_start > q_end:
+            events.append(('rest', None, next_start - q_end, None))
+    return events, merged
+
+
+def fold_loops(events):
+    """
+    Folds runs of repeated events into ('loop', count, body) where it saves flash.  Greedy:
+    at each point take the repeat that saves the most bytes.
+    """
+    def size(evs):
+        return sum(NOTE_BYTES if e[0] == 'note' else REST_BYTES for e in evs)
+
+    def same(a, b):
+        return all(x[:3] == y[:3] for x, y in zip(a, b))
+
+    out = []
+    i = 0
+    while i < len(events):
+        best = None
+        for length in range(1, min(MAX_LOOP_EVENTS, (len(events) - i) // 2) + 1):
+            body = events[i:i + length]
+            count = 1
+            while count < 255 and i + (count + 1) * length <= len(events) \
+                    and same(events[i + count * length:i + (count + 1) * length], body):
+                count += 1
+            saved = (count - 1) * size(body) - LOOP_BYTES - NEXT_BYTES
+            if count > 1 and saved > 0 and (best is None or saved > best[0]):
+                best = (saved, length, count)
+        if best:
+            _, length, count = best
+            out.append(('loop', count, events[i:i + length]))
+            i += length * count
+        else:
+            out.append(events[i])
+            i += 1
+    return out
+
+
+#############################################################################################
+# W r i t i n g   t h e   t a b l e
+#############################################################################################
+
+def pitch_names(flats):
+    """PITCH_XXX names by note number from action.h, preferring flats or sharps"""
+    with open(ACTION_H) as f:
+        text = f.read()
+    names = {}
+    for name, number in re.findall(r'\b(PITCH_[A-G][SF]?\d)\s*=\s*(\d+)', text):
+        number = int(number)
+        accidental = name[7:8] if len(name) > 8 else ''
+        prefer = 'F' if flats else 'S'
+        if number not in names or accidental == prefer:
+            names[number] = name
+    return names
+
+
+def note_expr(length):
+    """NOTE_XXX (or a sum of them) for a length in 32nds"""
+    parts = []
+    for value, name in NOTE_NAMES:
+        while length >= value:
+            parts.append(name)
+            length -= value
+    return ' + '.join(parts)
+
+
+def table_bytes(events):
+    total = 0
+    for e in events:
+        if e[0] == 'loop':
+            total += LOOP_BYTES + table_bytes(e[2]) + NEXT_BYTES
+        else:
+            total += NOTE_BYTES if e[0] == 'note' else REST_BYTES
+    return total
+
+
+def timing_error(events, note_ms, source_ms):
+    """Returns the largest and RMS difference in ms between where the notes start when
+    played and where source_ms() puts them"""
+    played = 0
+    errors = []
+    for kind, _, length, source in events:
+        if kind == 'note':
+            errors.append(played - source_ms(source))
+        played += note_ms * length
+    if not errors:
+        return 0.0, 0.0
+    worst = max(abs(e) for e in errors)
+    rms = math.sqrt(sum(e * e for e in errors) / len(errors))
+    return worst, rms
+
+
+def write_table(out, name, style, events, names):
+    def line(indent, text):
+        out.write('  ' * indent + text + ',\n')
+
+    def write_events(evs, indent):
+        for e in evs:
+            if e[0] == 'loop':
+                line(indent, 'SEQ_LOOP(%d)' % e[1])
+                write_events(e[2], indent + 1)
+                line(indent, 'SEQ_NEXT()')
+            elif e[0] == 'note':
+                pitch = names.get(e[1], str(e[1]))
+                line(indent, 'SEQ_NOTE(%s, %s, %s)' % (style, pitch, note_expr(e[2])))
+            else:
+                line(indent, 'SEQ_REST(%s, %s)' % (style, note_expr(e[2])))
+
+    table = 'sound%s%sTbl' % (name[:1].upper(), name[1:])
+    out.write('const uint8_t %s[] PROGMEM = \n{\n' % table)
+    write_events(events, 1)
+    out.write('  SEQ_END()\n};\n')
+
+
+def list_tracks(tracks, division, tempos):
+    for track in tracks:
+        if not track.notes:
+            print('track %d %-20s no notes' % (track.index, '"%s"' % track.name))
+            continue
+        low = min(n[3] for n in track.notes)
+        high = max(n[3] for n in track.notes)
+        print('track %d %-20s %4d notes, channels %s, notes %d-%d, %.1f s' % (
+            track.index, '"%s"' % track.name, len(track.notes),
+            ','.join(str(c) for c in sorted(track.channels)), low, high,
+            tick_to_ms(track.notes[-1][1], division, tempos) / 1000.0))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a MIDI melody to a soundSequence table')
+    parser.add_argument('midi', help='Standard MIDI File (format 0 or 1)')
+    parser.add_argument('--list', action='store_true', help='list the tracks and stop')
+    parser.add_argument('--track', type=int, help='track to take (default: the first with notes)')
+    parser.add_argument('--channel', type=int, help='only this channel, 1-16 (default: all)')
+    parser.add_argument('--grid', choices=sorted(GRIDS), default='32nd', help='shortest note kept')
+    parser.add_argument('--tempo', type=int, help='BPM to play at (default: the file\'s first tempo)')
+    parser.add_argument('--articulate', choices=sorted(ARTICULATIONS), default='staccato')
+    parser.add_argument('--transpose', type=int, default=0, help='semitones')
+    parser.add_argument('--no-loops', action='store_true', help='don\'t fold repeats into SEQ_LOOP')
+    parser.add_argument('--name', help='table is sound<Name>Tbl (default: from the file name)')
+    parser.add_argument('-o', '--out', help='write the table here instead of to stdout')
+    args = parser.parse_args()
+
+    try:
+        division, tracks, tempos, keys = read_midi(args.midi)
+    except (ValueError, IndexError, struct.error) as e:
+        sys.exit('%s: %s' % (args.midi, e if str(e) else 'file is truncated'))
+
+    if args.list:
+        list_tracks(tracks, division, tempos)
+        return 0
+
+    if args.track is None:
+        with_notes = [t for t in tracks if t.notes]
+        if not with_notes:
+            sys.exit('%s: no notes' % args.midi)
+        track = with_notes[0]
+    elif 0 <= args.track < len(tracks):
+        track = tracks[args.track]
+    else:
+        sys.exit('%s: there is no track %d (see --list)' % (args.midi, args.track))
+
+    notes = [(s, e, c, n + args.transpose) for s, e, c, n in track.notes
+             if args.channel is None or c == args.channel]
+    if not notes:
+        sys.exit('%s: track %d has no notes on that channel' % (args.midi, track.index))
+
+    notes, dropped = melody(notes)
+    step = GRIDS[args.grid]
+    # Drop the silence before the first note so the song starts when the sequence does
+    first = notes[0][0]
+    played, merged = quantize(notes, division * step / 8.0, step, first)
+    events = played if args.no_loops else fold_loops(played)
+
+    if args.tempo:
+        tempo = args.tempo
+    else:
+        tempo = int(round(60000000.0 / tempos[0][1])) if tempos else 120
+    note_ms = 60000 // tempo // 8      # songStyle::noteMs
+    if note_ms * max(e[2] for e in played) > 0xFFFF:
+        sys.exit('%s: a note is too long for SEQ_NOTE at %d BPM' % (args.midi, tempo))
+
+    base = os.path.splitext(os.path.basename(args.midi))[0]
+    name = args.name or ''.join(w.capitalize() for w in re.split(r'[^0-9A-Za-z]+', base) if w)
+    style = '%s%sStyle' % (name[:1].lower(), name[1:])
+    flats = keys and keys[0][1] < 0
+    names = pitch_names(flats)
+    unnamed = sorted(set(e[1] for e in played if e[0] == 'note' and e[1] not in names))
+
+    size = table_bytes(events) + END_BYTES
+    if args.tempo:
+        # Played at a tempo of our own, so compare with the file's beats at that tempo
+        def source_ms(tick):
+            return (tick - first) * 60000.0 / tempo / division
+    else:
+        def source_ms(tick):
+            return tick_to_ms(tick, division, tempos) - tick_to_ms(first, division, tempos)
+    worst, rms = timing_error(played, note_ms, source_ms)
+    count = sum(1 for e in played if e[0] == 'note')
+    stats = [
+        '%d notes, %d bytes of flash' % (count, size),
+        'quantized to %s notes at %d BPM: starts off by %.1f ms at most, %.1f ms RMS' % (
+            args.grid, tempo, worst, rms),
+    ]
+    if dropped or merged:
+        stats.append('left out: %d notes under the melody, %d that rounded onto another' % (
+            dropped, merged))
+
+    tempo_expr = TEMPO_NAMES.get(tempo, str(tempo))
+    comment = [
+        'Generated by tools/midi_import.py from %s (track %d%s, %s grid).  Don\'t edit, run it '
+        'again.' % (os.path.basename(args.midi), track.index,
+                    ', channel %d' % args.channel if args.channel else '', args.grid),
+    ] + stats
+
+    out = open(args.out, 'w') if args.out else sys.stdout
+    for text in comment:
+        out.write('// %s\n' % text)
+    out.write('constexpr songStyle %s(%s, ARTICULATE_%s);\n' % (style, tempo_expr, args.articulate.upper()))
+    write_table(out, name, style, events, names)
+    if args.out:
+        out.close()
+
+    for text in stats:
+        sys.stderr.write('%s\n' % text)
+    if unnamed:
+        sys.stderr.write('warning: notes %s have no PITCH_XXX name, try --transpose\n' %
+                         ', '.join(str(n) for n in unnamed))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
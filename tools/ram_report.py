@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+#############################################################################################
+#
+# ram_report.py - shows where the sketch's RAM goes, from a build's object files.
+#
+#   arduino-cli compile --build-path build silly_box
+#   ram_report.py build
+#   ram_report.py --save ram.json build          # remember this build
+#   ram_report.py --baseline ram.json build      # compare with it
+#
+# Prints the variables (.data and .bss, which includes the vtables on AVR) of each source
+# file, of each sequence object in tables.cpp, and the largest single variables (the group
+# tables among them), then what is left of the RAM for the stack.  Only what the linker kept
+# is counted.
+#
+# With --baseline every line shows the change and the exit status is 1 if the total has
+# grown by more than --allow bytes.  --min-free fails the same way if less than that is
+# left for the stack (see silly_box/stackmonitor.h for how much the stack actually uses).
+#
+# Runs avr-nm and avr-size, so the Arduino AVR tools have to be on the PATH (or use
+# --prefix with their full path, e.g. ~/.arduino15/packages/arduino/tools/avr-gcc/7.3.0-
+# atmel3.6.1-arduino7/bin/avr-).
+#
+#############################################################################################
+
+#############################################################################################
+#
+#  Copyright 2021, Todd W. Lumpkin
+#
+#  This file is part of the "Silly Box" program.
+#
+#  "Silly Box" is free software: you can redistribute it and/or modify it under the terms
+#  of the GNU General Public License as published by the Free Software Foundation,
+#  version 3 of the License.
+#
+#  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+#  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#  See the GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License along with "Silly Box"
+#  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+#
+#############################################################################################
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+SKETCH = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'silly_box')
+RAM_BYTES = 2048            # ATmega328
+RAM_SECTIONS = ('.data', '.bss', '.noinit')
+
+# Variables as nm sees them.  Constants that aren't PROGMEM are copied to RAM on AVR, so
+# read only ('r') counts too.
+RAM_TYPES = 'dDbBrR'
+
+# Where avr-ld puts RAM.  PROGMEM constants are read only too but sit below this in flash.
+AVR_RAM_ADDRESS = 0x800000
+
+# Classes whose objects in tables.cpp are listed one by one
+OBJECT_CLASSES = ('moveSequence', 'ledSequence', 'soundSequence')
+
+
+def run(tool, *args):
+    try:
+        return subprocess.run([tool] + list(args), check=True, stdout=subprocess.PIPE,
+                              universal_newlines=True).stdout
+    except FileNotFoundError:
+        sys.exit('%s not found, see --prefix' % tool)
+    except subprocess.CalledProcessError as e:
+        sys.exit('%s failed (%d)' % (tool, e.returncode))
+
+
+def ram_symbols(prefix, path):
+    """Returns {name: bytes} for the variables defined in an object or ELF file.  Object
+    files can't tell PROGMEM from RAM, so only what is also in the ELF counts."""
+    symbols = []
+    for line in run(prefix + 'nm', '-S', '-C', '--defined-only', path).splitlines():
+        m = re.match(r'^([0-9a-fA-F]+) ([0-9a-fA-F]+) (\w) (.+)$', line)
+        if m and m.group(3) in RAM_TYPES:
+            symbols.append((int(m.group(1), 16), int(m.group(2), 16), m.group(4)))
+    if any(address >= AVR_RAM_ADDRESS for address, size, name in symbols):
+        symbols = [s for s in symbols if s[0] >= AVR_RAM_ADDRESS]
+    sizes = {}
+    for address, size, name in symbols:
+        sizes[name] = sizes.get(name, 0) + size
+    return sizes
+
+
+def ram_total(prefix, elf):
+    """The RAM the linked sketch starts with, from its section sizes"""
+    total = 0
+    for line in run(prefix + 'size', '-A', elf).splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in RAM_SECTIONS:
+            total += int(fields[1])
+    return total
+
+
+def unit_name(path):
+    """silly_box.ino.cpp.o -> silly_box.ino, tables.cpp.o -> tables.cpp"""
+    name = os.path.basename(path)
+    name = re.sub(r'\.o$', '', name)
+    return re.sub(r'\.ino\.cpp$', '.ino', name)
+
+
+def table_objects(sketch):
+    """Returns [(class, name)] for the objects defined in tables.cpp, in order"""
+    with open(os.path.join(sketch, 'tables.cpp')) as f:
+        text = f.read()
+    pattern = r'^(%s)\s+(\w+)\s*\(' % '|'.join(OBJECT_CLASSES)
+    return re.findall(pattern, text, re.M)
+
+
+def report_line(name, size, baseline):
+    if baseline is None:
+        return '  %-40s %5d' % (name, size)
+    old = baseline.get(name)
+    change = 'new' if old is None else '' if old == size else '%+d' % (size - old)
+    return '  %-40s %5d %6s' % (name, size, change)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Show where the sketch\'s RAM goes')
+    parser.add_argument('build', help='arduino-cli --build-path folder')
+    parser.add_argument('--sketch', default=SKETCH, help='sketch folder with tables.cpp')
+    parser.add_argument('--prefix', default='avr-', help='prefix for nm and size')
+    parser.add_argument('--top', type=int, default=15, help='how many of the largest variables to list')
+    parser.add_argument('--save', help='write the sizes to this file for a later --baseline')
+    parser.add_argument('--baseline', help='compare with sizes saved by --save')
+    parser.add_argument('--allow', type=int, default=0, help='growth over --baseline that is not an error')
+    parser.add_argument('--min-free', type=int, default=0, help='fail if less than this is left for the stack')
+    args = parser.parse_args()
+
+    elfs = glob.glob(os.path.join(args.build, '*.ino.elf')) or glob.glob(os.path.join(args.build, '*.elf'))
+    if len(elfs) != 1:
+        sys.exit('%s: expected one .elf file, found %d' % (args.build, len(elfs)))
+    objects = sorted(glob.glob(os.path.join(args.build, 'sketch', '*.o')))
+    if not objects:
+        sys.exit('%s: no object files in sketch/' % args.build)
+
+    kept = ram_symbols(args.prefix, elfs[0])
+    total = ram_total(args.prefix, elfs[0])
+
+    units = {}
+    for path in objects:
+        symbols = ram_symbols(args.prefix, path)
+        units[unit_name(path)] = sum(size for name, size in symbols.items() if name in kept)
+    # Everything else: the Arduino core, libraries and the C runtime
+    units['(core and libraries)'] = total - sum(units.values())
+
+    table = {}
+    classes = {}
+    for cls, name in table_objects(args.sketch):
+        if name in kept:
+            table[name] = kept[name]
+            count, size = classes.get(cls, (0, 0))
+            classes[cls] = (count + 1, size + kept[name])
+
+    base = {'total': None, 'units': None, 'objects': None}
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = json.load(f)
+
+    print('RAM by source file')
+    for name, size in sorted(units.items(), key=lambda item: -item[1]):
+        print(report_line(name, size, base['units']))
+
+    print('\ntables.cpp objects')
+    for cls in OBJECT_CLASSES:
+        if cls in classes:
+            count, size = classes[cls]
+            print('  %-40s %5d  (%d x %d)' % (cls, size, count, size // count))
+    for name, size in table.items():
+        print(report_line(name, size, base['objects']))
+
+    print('\nLargest variables')
+    for name, size in sorted(kept.items(), key=lambda item: -item[1])[:args.top]:
+        print('  %-40s %5d' % (name, size))
+
+    free = RAM_BYTES - total
+    print('\nVariables %d of %d bytes, %d left for the stack' % (total, RAM_BYTES, free))
+
+    ok = True
+    if base['total'] is not None:
+        print('Change since the baseline: %+d bytes' % (total - base['total']))
+        if total - base['total'] > args.allow:
+            print('RAM has grown by more than %d bytes' % args.allow)
+            ok = False
+    if free < args.min_free:
+        print('Less than %d bytes left for the stack' % args.min_free)
+        ok = False
+
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump({'total': total, 'units': units, 'objects': table}, f, indent=2, sort_keys=True)
+            f.write('\n')
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+#############################################################################################
+#
+# trace_decode.py - prints the sketch's trace log (see silly_box/trace.h) as text.
+#
+#   stty -F /dev/ttyUSB0 115200 raw -echo && trace_decode.py /dev/ttyUSB0
+#   trace_decode.py saved_log.bin
+#
+# Each message is its one byte ID followed by its arguments.  The IDs and the text they
+# stand for are read from silly_box/tracemsgs.h, so decode with the tree the sketch was
+# built from.  The log has to be read from the start (opening the port resets the Nano);
+# if an unknown ID turns up the decoder says so and waits for the next TR_BOOT.
+#
+#############################################################################################
+
+#############################################################################################
+#
+#  Copyright 2021, Todd W. Lumpkin
+#
+#  This file is part of the "Silly Box" program.
+#
+#  "Silly Box" is free software: you can redistribute it and/or modify it under the terms
+#  of the GNU General Public License as published by the Free Software Foundation,
+#  version 3 of the License.
+#
+#  "Silly Box" is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+#  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#  See the GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License along with "Silly Box"
+#  in a file named gpl-3.0.txt.  If not, see <https://www.gnu.org/licenses/>.
+#
+#############################################################################################
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SKETCH = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'silly_box')
+
+# Argument types, see tracemsgs.h
+HIST_BUCKETS = 16   # reactionTimer::numBuckets
+CYCLES_PER_COUNT = 8    # profiler::cyclesPerCount
+ARG_TYPES = {'u8': '<B', 'u16': '<H', 'i16': '<h', 'u32': '<I', 'action': '<B',
+             'hist': '<%dB' % HIST_BUCKETS, 'prof': '<IHH', 'section': '<B'}
+
+
+def read_messages(path):
+    """Returns (name, text, [argument types]) for each ID"""
+    with open(path) as f:
+        text = f.read()
+    messages = []
+    for name, body in re.findall(r'^TRACE_MSG\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', text, re.M):
+        messages.append((name, body, re.findall(r'\{(\w+)\}', body)))
+    for name, body, args in messages:
+        for arg in args:
+            if arg not in ARG_TYPES:
+                sys.exit('%s: %s has an argument of unknown type {%s}' % (path, name, arg))
+    return messages
+
+
+def read_actions(path):
+    """Returns the ACTION_XXX names in the order of the actionType enum"""
+    with open(path) as f:
+        text = f.read()
+    body = re.search(r'enum actionType[^{]*\{(.*?)\};', text, re.S).group(1)
+    body = re.sub(r'//[^\n]*', '', body)
+    return re.findall(r'\b(ACTION_\w+)\b', body)
+
+
+def read_sections(path):
+    """Returns the PROF_XXX names in the order of the profileSection enum"""
+    with open(path) as f:
+        text = f.read()
+    body = re.search(r'enum profileSection[^{]*\{(.*?)\};', text, re.S).group(1)
+    body = re.sub(r'//[^\n]*', '', body)
+    return re.findall(r'\b(PROF_\w+)\b', body)
+
+
+def histogram(counts):
+    """A reactionTimer histogram with its percentiles.  Bucket n holds times under 2^n ms
+    (the last one everything longer) so a percentile is given as the top of its bucket."""
+    total = sum(counts)
+    if total == 0:
+        return 'no samples'
+
+    def top(n):
+        return '>=%d ms' % (1 << (n - 1)) if n == len(counts) - 1 else '<%d ms' % (1 << n)
+
+    def percentile(p):
+        seen = 0
+        for n, count in enumerate(counts):
+            seen += count
+            if seen * 100 >= p * total:
+                return top(n)
+
+    last = max(n for n, count in enumerate(counts) if count)
+    return 'n=%d p50%s p90%s p99%s max%s  [%s]' % (
+        total, percentile(50), percentile(90), percentile(99), top(last),
+        ' '.join(str(c) for c in counts))
+
+
+def profile(total, calls, longest):
+    """A profiler row (see profiler.h), times in cycles"""
+    return 'calls=%-5d avg=%-7d max=%-7d total=%d' % (
+        calls, total * CYCLES_PER_COUNT // calls, longest * CYCLES_PER_COUNT,
+        total * CYCLES_PER_COUNT)
+
+
+class Decoder:
+    def __init__(self, messages, actions, sections):
+        self.messages = messages
+        self.actions = actions
+        self.sections = sections
+        self.pending = b''
+        self.synced = True
+
+    def feed(self, data):
+        """Decodes what it can of the bytes so far, returning the lines of text"""
+        self.pending += data
+        lines = []
+        while self.pending:
+            msg_id = self.pending[0]
+            if not self.synced:
+                # Wait for the sketch to start again
+                if msg_id != 0:
+                    self.pending = self.pending[1:]
+                    continue
+                self.synced = True
+            if msg_id >= len(self.messages):
+                lines.append('?? unknown message ID %d, skipping to the next TR_BOOT' % msg_id)
+                self.synced = False
+                self.pending = self.pending[1:]
+                continue
+
+            name, text, args = self.messages[msg_id]
+            size = 1 + sum(struct.calcsize(ARG_TYPES[a]) for a in args)
+            if len(self.pending) < size:
+                break
+            pos = 1
+            values = []
+            for arg in args:
+                fields = struct.unpack_from(ARG_TYPES[arg], self.pending, pos)
+                value = fields[0]
+                pos += struct.calcsize(ARG_TYPES[arg])
+                if arg == 'hist':
+                    value = histogram(fields)
+                elif arg == 'prof':
+                    value = profile(*fields)
+                elif arg == 'action':
+                    value = self.actions[value] if value < len(self.actions) else 'ACTION_%d' % value
+                elif arg == 'section':
+                    value = self.sections[value] if value < len(self.sections) else 'PROF_%d' % value
+                values.append(str(value))
+            self.pending = self.pending[size:]
+            lines.append(re.sub(r'\{\w+\}', lambda m: values.pop(0), text))
+        return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the sketch\'s trace log')
+    parser.add_argument('log', nargs='?', help='serial port or saved log (default: stdin)')
+    parser.add_argument('--sketch', default=SKETCH, help='sketch folder with tracemsgs.h, action.h and profiler.h')
+    args = parser.parse_args()
+
+    decoder = Decoder(read_messages(os.path.join(args.sketch, 'tracemsgs.h')),
+                      read_actions(os.path.join(args.sketch, 'action.h')),
+                      read_sections(os.path.join(args.sketch, 'profiler.h')))
+    source = open(args.log, 'rb', buffering=0) if args.log else sys.stdin.buffer
+    try:
+        while True:
+            data = source.read(256) if not args.log else os.read(source.fileno(), 256)
+            if not data:
+                break
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    if decoder.pending:
+        sys.stderr.write('(%d bytes of an unfinished message at the end)\n' % len(decoder.pending))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())